@@ -0,0 +1,664 @@
+#include "ConcurrentList.h"
+#include "ListView.h"
+#include "PagedList.h"
+#include "RemovingDuplicates.h"
+#include "Serialization.h"
+#include "UringSink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace bench {
+
+constexpr auto FILE_NAME = "bench_buffer";
+
+/**
+ * Builds a list of short strings with random links.
+ *
+ * @param distinct the number of distinct payloads, 0 if all of them are random.
+ */
+void fill(solution::List & list, std::size_t size, std::size_t max_length, std::size_t distinct = 0)
+{
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<std::size_t> length(1, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<solution::List::Iterator> nodes;
+    nodes.reserve(size);
+    std::vector<std::string> payloads(distinct == 0 ? size : distinct);
+    for (auto & data : payloads) {
+        data.resize(length(generator));
+        for (auto & c : data) {
+            c = static_cast<char>(letter(generator));
+        }
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        nodes.push_back(list.push_back(payloads[i % payloads.size()]));
+    }
+    std::uniform_int_distribution<std::size_t> index(0, size - 1);
+    for (auto & node : nodes) {
+        node.link(nodes[index(generator)]);
+    }
+}
+
+/**
+ * @param prepare called before every run, it is not measured.
+ * @return the best time of several runs in seconds.
+ */
+double measure(const std::function<void()> & action, int runs = 3, const std::function<void()> & prepare = {})
+{
+    double best = 0;
+    for (int i = 0; i < runs; ++i) {
+        if (prepare) {
+            prepare();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        action();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+long file_size()
+{
+    auto * file = std::fopen(FILE_NAME, "rb");
+    std::fseek(file, 0, SEEK_END);
+    const auto size = std::ftell(file);
+    std::fclose(file);
+    return size;
+}
+
+void report(const char * name, double seconds, long bytes)
+{
+    std::printf("%-36s %10.3f ms %10.1f MiB/s\n", name, seconds * 1e3, static_cast<double>(bytes) / seconds / (1 << 20));
+}
+
+void serialization(const char * name, const solution::SerializeOptions & options, std::size_t distinct = 0)
+{
+    solution::List list;
+    fill(list, 1000000, 32, distinct);
+
+    const auto write = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "wb");
+        list.serialize(file, options);
+        std::fclose(file);
+    });
+    const auto size = file_size();
+    report((std::string(name) + " serialize").c_str(), write, size);
+
+    solution::List deserialized;
+    const auto read = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "rb");
+        deserialized.deserialize(file);
+        std::fclose(file);
+    });
+    report((std::string(name) + " deserialize").c_str(), read, size);
+    std::printf("%-36s %10ld bytes\n", (std::string(name) + " file size").c_str(), size);
+}
+
+void scaling()
+{
+    solution::List list;
+    fill(list, 4000000, 32);
+    for (const std::size_t threads : {1, 2, 4, 8, 16, 32}) {
+        solution::SerializeOptions options;
+        options.threads = threads;
+        const auto write = measure([&] {
+            auto * file = std::fopen(FILE_NAME, "wb");
+            list.serialize(file, options);
+            std::fclose(file);
+        });
+        report(("v2 serialize, threads: " + std::to_string(threads)).c_str(), write, file_size());
+    }
+    for (const std::size_t threads : {1, 2, 4, 8, 16, 32}) {
+        solution::List deserialized;
+        const auto read = measure([&] {
+            auto * file = std::fopen(FILE_NAME, "rb");
+            deserialized.deserialize(file, {threads});
+            std::fclose(file);
+        });
+        report(("v2 deserialize, threads: " + std::to_string(threads)).c_str(), read, file_size());
+    }
+}
+
+void background()
+{
+    solution::List list;
+    fill(list, 4000000, 32);
+    auto * file = std::fopen(FILE_NAME, "wb");
+    std::future<int> result;
+    // The caller is paused for fork() only
+    const auto pause = measure([&] { result = list.serialize_async(file); }, 1);
+    const auto total = pause + measure([&] { result.get(); }, 1);
+    std::fclose(file);
+    report("v2 background serialize, pause", pause, file_size());
+    report("v2 background serialize, total", total, file_size());
+}
+
+/**
+ * Traversals of a list whose order differs from the order of its nodes in memory.
+ */
+void frozen()
+{
+    std::mt19937_64 generator(42);
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes{list.end()};
+    for (std::size_t i = 0; i < 4000000; ++i) {
+        std::uniform_int_distribution<std::size_t> position(0, nodes.size() - 1);
+        nodes.push_back(list.insert(nodes[position(generator)], std::to_string(i)));
+    }
+    std::uniform_int_distribution<std::size_t> index(1, nodes.size() - 1);
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+        nodes[i].link(nodes[index(generator)]);
+    }
+    nodes.clear();
+
+    std::size_t checksum = 0;
+    const auto traverse = [&] {
+        for (const auto data : list) {
+            checksum += data.size();
+        }
+        auto it = list.begin();
+        for (std::size_t i = 0; i < list.size() && it != list.end(); ++i) {
+            checksum += it.move()->size();
+        }
+    };
+    std::vector<char> buffer;
+    const auto serialize = [&] {
+        buffer.clear();
+        solution::io::BufferSink sink(buffer);
+        list.serialize(sink);
+    };
+    const auto bytes = static_cast<long>(list.size() * (sizeof(void *) * 2));
+    report("nodes, traversal", measure(traverse), bytes);
+    const auto nodes_serialize = measure(serialize);
+    report("nodes, serialize to memory", nodes_serialize, static_cast<long>(buffer.size()));
+    report("freeze", measure([&] { list.freeze(); }, 1), bytes);
+    report("frozen, traversal", measure(traverse), bytes);
+    const auto frozen_serialize = measure(serialize);
+    report("frozen, serialize to memory", frozen_serialize, static_cast<long>(buffer.size()));
+    report("thaw", measure([&] { list.thaw(); }, 1), bytes);
+    std::printf("%-36s %10zu\n", "checksum", checksum);
+}
+
+/**
+ * Traversals in "random" order, the links form a single cycle through all nodes.
+ */
+void compaction(const std::size_t size)
+{
+    std::mt19937_64 generator(42);
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes;
+    nodes.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        nodes.push_back(list.push_back(std::to_string(i)));
+    }
+    std::shuffle(nodes.begin(), nodes.end(), generator);
+    for (std::size_t i = 0; i < size; ++i) {
+        nodes[i].link(nodes[(i + 1) % size]);
+    }
+    const auto first = nodes.front();
+    nodes = {};
+
+    std::size_t checksum = 0;
+    const auto visit = [&checksum](std::string_view data) {
+        checksum += data.size() + static_cast<unsigned char>(data[0]);
+    };
+    const auto plain = [&] {
+        auto it = list.begin();
+        for (std::size_t i = 0; i < size; ++i, it.move()) {
+            visit(*it);
+        }
+    };
+    const auto prefetching = [&] {
+        list.for_each_random(list.begin(), size, visit);
+    };
+    const auto bytes = static_cast<long>(size * sizeof(void *) * 4);
+    const auto name = [size](const char * what) {
+        return std::to_string(size) + " nodes, " + what;
+    };
+    // Every traversal starts at the first node of the cycle
+    list.insert(first, "first").link(first);
+    report(name("move()").c_str(), measure(plain, 1), bytes);
+    report(name("prefetch").c_str(), measure(prefetching, 1), bytes);
+    report(name("compact").c_str(), measure([&] { list.compact(solution::List::Order::RANDOM); }, 1), bytes);
+    report(name("compacted move()").c_str(), measure(plain, 1), bytes);
+    report(name("compacted prefetch").c_str(), measure(prefetching, 1), bytes);
+    std::printf("%-36s %10zu\n", "checksum", checksum);
+}
+
+/**
+ * Random positional reads and inserts without and with the order-statistic index.
+ */
+void positional()
+{
+    constexpr std::size_t size = 100000;
+    constexpr std::size_t operations = 10000;
+    solution::List list;
+    for (std::size_t i = 0; i < size; ++i) {
+        list.push_back(std::to_string(i));
+    }
+    std::size_t checksum = 0;
+    const auto run = [&] {
+        std::mt19937_64 generator(42);
+        for (std::size_t i = 0; i < operations; ++i) {
+            std::uniform_int_distribution<std::size_t> position(0, list.size() - 1);
+            const auto it = list.at(position(generator));
+            checksum += it->size() + list.index_of(it);
+            list.erase(list.insert(list.at(position(generator)), "x"));
+        }
+    };
+    const auto bytes = static_cast<long>(operations * sizeof(void *));
+    report("at()/index_of(), walk", measure(run, 1), bytes);
+    report("enable_index", measure([&] { list.enable_index(); }, 1), bytes);
+    report("at()/index_of(), index", measure(run, 1), bytes);
+    std::printf("%-36s %10zu\n", "checksum", checksum);
+}
+
+/**
+ * The same numbers in a list of strings and in a list of integers.
+ */
+void typed()
+{
+    std::mt19937_64 generator(42);
+    solution::List strings;
+    solution::BasicList<std::uint64_t> numbers;
+    for (std::size_t i = 0; i < 1000000; ++i) {
+        const auto value = generator();
+        strings.push_back({reinterpret_cast<const char *>(&value), sizeof(value)});
+        numbers.push_back(value);
+    }
+    const auto write_strings = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "wb");
+        strings.serialize(file);
+        std::fclose(file);
+    });
+    report("List<string> serialize", write_strings, file_size());
+    const auto read_strings = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "rb");
+        strings.deserialize(file);
+        std::fclose(file);
+    });
+    report("List<string> deserialize", read_strings, file_size());
+    const auto write_numbers = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "wb");
+        numbers.serialize(file);
+        std::fclose(file);
+    });
+    report("List<uint64_t> serialize", write_numbers, file_size());
+    const auto read_numbers = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "rb");
+        numbers.deserialize(file);
+        std::fclose(file);
+    });
+    report("List<uint64_t> deserialize", read_numbers, file_size());
+}
+
+void sinks()
+{
+    solution::List list;
+    fill(list, 4000000, 32);
+    const auto stdio = measure([&] {
+        auto * file = std::fopen(FILE_NAME, "wb");
+        list.serialize(file);
+        std::fclose(file);
+    });
+    report("v2 serialize to FILE", stdio, file_size());
+    const auto descriptor = measure([&] {
+        const auto fd = open(FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        solution::io::FdSink sink(fd);
+        list.serialize(sink);
+        close(fd);
+    });
+    report("v2 serialize to fd", descriptor, file_size());
+    std::vector<char> buffer;
+    const auto memory = measure([&] {
+        buffer.clear();
+        solution::io::BufferSink sink(buffer);
+        list.serialize(sink);
+    });
+    report("v2 serialize to memory", memory, static_cast<long>(buffer.size()));
+    bool direct = false;
+    bool asynchronous = false;
+    const auto uring = measure([&] {
+        solution::io::UringSink sink(FILE_NAME);
+        list.serialize(sink);
+        direct = sink.direct();
+        asynchronous = sink.asynchronous();
+    });
+    report(direct ? (asynchronous ? "v2 serialize to io_uring, O_DIRECT" : "v2 serialize to pwrite, O_DIRECT")
+                  : (asynchronous ? "v2 serialize to io_uring" : "v2 serialize to pwrite"),
+           uring,
+           file_size());
+}
+
+void mapping()
+{
+    solution::List list;
+    fill(list, 1000000, 32);
+    solution::SerializeOptions options;
+    options.index = true;
+    auto * file = std::fopen(FILE_NAME, "wb");
+    list.serialize(file, options);
+    std::fclose(file);
+    const auto size = file_size();
+
+    solution::ListView view;
+    const auto open = measure([&] {
+        file = std::fopen(FILE_NAME, "rb");
+        view.open(file);
+        std::fclose(file);
+    });
+    report("v2 indexed mmap open", open, size);
+
+    std::size_t total = 0;
+    const auto walk = measure([&] {
+        for (const auto data : view) {
+            total += data.size();
+        }
+    });
+    report("v2 indexed mmap walk", walk, size);
+
+    const auto random_walk = measure([&] {
+        auto it = view.begin();
+        for (std::size_t i = 0; i < view.size() && it != view.end(); ++i) {
+            total += it.move()->size();
+        }
+    });
+    report("v2 indexed mmap random walk", random_walk, size);
+}
+
+/**
+ * Operations per second on a list shared between threads: a reader walks
+ * a few nodes and follows their "random" links, every tenth operation
+ * inserts or erases a node.
+ */
+void concurrent()
+{
+    constexpr std::size_t size = 100000;
+    constexpr std::size_t operations = 200000;
+    constexpr std::size_t walk = 16;
+
+    const auto run = [](std::size_t threads, auto && operation) {
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([&operation, i, threads] {
+                std::mt19937_64 generator(i);
+                for (std::size_t j = 0; j < operations / threads; ++j) {
+                    operation(generator, j);
+                }
+            });
+        }
+        for (auto & worker : workers) {
+            worker.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(operations) / elapsed.count();
+    };
+
+    std::atomic<std::size_t> checksum{0};
+    const auto max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 4);
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        solution::List list;
+        fill(list, size, 32);
+        std::mutex mutex;
+        const auto locked = run(threads, [&](std::mt19937_64 & generator, std::size_t j) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = list.begin();
+            for (auto steps = generator() % walk; steps > 0 && it != list.end(); --steps, ++it) {
+                checksum += it.next() != list.end();
+            }
+            if (j % 10 == 0 && it != list.end()) {
+                list.erase(list.insert(it, "inserted"));
+            }
+        });
+
+        solution::ConcurrentList shared;
+        {
+            solution::ConcurrentList::Guard guard(shared);
+            std::vector<solution::ConcurrentList::ConstIterator> nodes;
+            for (std::size_t i = 0; i < size; ++i) {
+                nodes.push_back(shared.push_back(std::to_string(i)));
+            }
+            std::mt19937_64 generator(42);
+            for (auto & node : nodes) {
+                shared.link(node, nodes[generator() % size]);
+            }
+        }
+        const auto lock_free = run(threads, [&](std::mt19937_64 & generator, std::size_t j) {
+            solution::ConcurrentList::Guard guard(shared);
+            auto it = shared.begin();
+            for (auto steps = generator() % walk; steps > 0 && it != shared.end(); --steps, ++it) {
+                checksum += it.next() != shared.end();
+            }
+            if (j % 10 == 0 && it != shared.end()) {
+                shared.erase(shared.insert(it, "inserted"));
+            }
+        });
+        std::printf("%2zu threads %20.0f ops/s locked %12.0f ops/s concurrent\n", threads, locked, lock_free);
+    }
+    std::printf("%-36s %10zu\n", "checksum", checksum.load());
+}
+
+/**
+ * Traversals of a list kept in files with page caches of several sizes.
+ */
+void paged()
+{
+    constexpr std::size_t size = 1000000;
+    solution::List list;
+    fill(list, size, 32);
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    list.serialize(sink);
+    list.clear();
+
+    std::size_t checksum = 0;
+    for (const std::size_t memory : {std::size_t{4} << 20, std::size_t{16} << 20, std::size_t{256} << 20}) {
+        std::remove(FILE_NAME);
+        solution::PagedList paged;
+        if (paged.open(FILE_NAME, memory) != 0) {
+            std::printf("cannot open %s\n", FILE_NAME);
+            return;
+        }
+        const auto bytes = static_cast<long>(buffer.size());
+        const auto prefix = std::to_string(memory >> 20) + " MiB cache, ";
+        report((prefix + "deserialize").c_str(), measure([&] {
+                   solution::io::MemorySource source(buffer.data(), buffer.size());
+                   paged.deserialize(source);
+               }, 1), bytes);
+        report((prefix + "traversal").c_str(), measure([&] {
+                   for (const auto & data : paged) {
+                       checksum += data.size();
+                   }
+               }, 1), bytes);
+        report((prefix + "random traversal").c_str(), measure([&] {
+                   auto it = paged.begin();
+                   for (std::size_t i = 0; i < size / 10 && it != paged.end(); ++i, it.move()) {
+                       checksum += it->size();
+                   }
+               }, 1), bytes / 10);
+        report((prefix + "flush").c_str(), measure([&] { paged.flush(); }, 1), bytes);
+        paged.clear();
+        paged.close();
+    }
+    std::remove((std::string(FILE_NAME) + ".payloads").c_str());
+    std::printf("%-36s %10zu\n", "checksum", checksum);
+}
+
+void duplicates()
+{
+    constexpr std::size_t size = 16 << 20;
+    static const char * const names[] = {"portable", "ssse3", "avx2", "avx512", "neon"};
+    std::mt19937 generator(42);
+    for (const std::size_t max_run : {std::size_t{1}, std::size_t{4}, std::size_t{64}}) {
+        std::string original;
+        while (original.size() < size) {
+            original.append(generator() % max_run + 1, static_cast<char>('a' + generator() % 26));
+        }
+        std::string str;
+        for (const auto kernel : {solution::DuplicatesKernel::PORTABLE, solution::remove_duplicates_kernel()}) {
+            const auto seconds = measure([&] {
+                str = original;
+                solution::remove_duplicates(str.data(), kernel);
+            });
+            const auto name = "runs of 1.." + std::to_string(max_run) + ", " + names[static_cast<int>(kernel)];
+            report(name.c_str(), seconds, static_cast<long>(size));
+        }
+        report("  length", measure([&] {
+                   str = original;
+                   solution::remove_duplicates(str.data(), str.size());
+               }), static_cast<long>(size));
+        for (const std::size_t threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+            const auto name = "  parallel, " + std::to_string(threads) + " threads";
+            report(name.c_str(), measure([&] {
+                       str = original;
+                       solution::remove_duplicates_parallel(str.data(), str.size(), threads);
+                   }), static_cast<long>(size));
+        }
+    }
+}
+
+void duplicates_stream()
+{
+    constexpr std::size_t size = 256 << 20;
+    {
+        std::mt19937 generator(42);
+        std::string block;
+        while (block.size() < (16 << 20)) {
+            block.append(generator() % 4 + 1, static_cast<char>('a' + generator() % 26));
+        }
+        auto * file = std::fopen(FILE_NAME, "wb");
+        for (std::size_t i = 0; i < size / block.size(); ++i) {
+            std::fwrite(block.data(), 1, block.size(), file);
+        }
+        std::fclose(file);
+    }
+    const auto input = ::open(FILE_NAME, O_RDONLY);
+    const auto output = ::open("/dev/null", O_WRONLY);
+    std::vector<char> buffer(1 << 20);
+    report("read only", measure([&] {
+               ::lseek(input, 0, SEEK_SET);
+               while (::read(input, buffer.data(), buffer.size()) > 0) {
+               }
+           }), static_cast<long>(size));
+    report("read by blocks", measure([&] {
+               ::lseek(input, 0, SEEK_SET);
+               solution::io::FdSource source(input);
+               solution::io::FdSink sink(output);
+               solution::remove_duplicates(source, sink);
+           }), static_cast<long>(size));
+    report("mapped", measure([&] {
+               ::lseek(input, 0, SEEK_SET);
+               solution::remove_duplicates(input, output);
+           }), static_cast<long>(size));
+    report("stdio", measure([&] {
+               auto * in = std::fopen(FILE_NAME, "rb");
+               auto * out = std::fopen("/dev/null", "wb");
+               solution::remove_duplicates(in, out);
+               std::fclose(in);
+               std::fclose(out);
+           }), static_cast<long>(size));
+    ::close(input);
+    ::close(output);
+}
+
+void duplicates_batch()
+{
+    constexpr std::size_t count = 1000000;
+    std::mt19937 generator(42);
+    std::vector<std::string> original(count);
+    std::size_t bytes = 0;
+    for (auto & str : original) {
+        const auto length = generator() % 32 + 1;
+        while (str.size() < length) {
+            str.append(generator() % 3 + 1, static_cast<char>('a' + generator() % 26));
+        }
+        bytes += str.size();
+    }
+    std::vector<std::string> strings;
+    std::vector<char *> pointers(count);
+    std::vector<std::size_t> lengths(count);
+    const auto reset = [&] {
+        strings = original;
+        for (std::size_t i = 0; i < count; ++i) {
+            pointers[i] = strings[i].data();
+            lengths[i] = strings[i].size();
+        }
+    };
+    std::size_t checksum = 0;
+    report("call per string", measure([&] {
+               for (std::size_t i = 0; i < count; ++i) {
+                   checksum += solution::remove_duplicates(pointers[i], lengths[i]);
+               }
+           }, 3, reset), static_cast<long>(bytes));
+    for (const std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+        const auto name = "batch, " + std::to_string(threads) + " threads";
+        report(name.c_str(), measure([&] {
+                   solution::remove_duplicates_batch(pointers.data(), lengths.data(), count, threads);
+                   checksum += lengths[0];
+               }, 3, reset), static_cast<long>(bytes));
+    }
+    std::printf("%-36s %10zu\n", "checksum", checksum);
+}
+
+} // namespace bench
+
+/**
+ * @param argv the largest list in the compaction benchmark, 10'000'000 nodes by default.
+ */
+int main(int argc, char ** argv)
+{
+    std::printf("1'000'000 nodes, payloads of 1..32 bytes, random links\n");
+    bench::serialization("v1", {solution::format::VERSION_1});
+    bench::serialization("v2", {solution::format::VERSION_2});
+    bench::serialization("v2 without checksums", {solution::format::VERSION_2, false, false, false, false});
+    std::printf("\n1'000'000 nodes, 16 distinct payloads of 1..32 bytes, random links\n");
+    bench::serialization("v2 low cardinality", {solution::format::VERSION_2}, 16);
+    bench::serialization("v2 dictionary", {solution::format::VERSION_2, false, true}, 16);
+    std::printf("\n1'000'000 nodes, 1'000 distinct payloads of 1..32 bytes, random links\n");
+    bench::serialization("v2 medium cardinality", {solution::format::VERSION_2}, 1000);
+    bench::serialization("v2 compressed", {solution::format::VERSION_2, false, false, true}, 1000);
+    std::printf("\n1'000'000 nodes, random payloads of 1..32 bytes, random links\n");
+    bench::serialization("v2 random compressed", {solution::format::VERSION_2, false, false, true});
+    bench::mapping();
+    std::printf("\n4'000'000 nodes, payloads of 1..32 bytes, random links\n");
+    bench::scaling();
+    bench::background();
+    bench::sinks();
+    std::printf("\n1'000'000 random 8-byte numbers without links\n");
+    bench::typed();
+    std::printf("\n4'000'000 nodes inserted at random positions, random links\n");
+    bench::frozen();
+    std::printf("\n100'000 nodes, 10'000 random positional reads and inserts\n");
+    bench::positional();
+    std::printf("\n1'000'000 nodes in files, payloads of 1..32 bytes, random links\n");
+    bench::paged();
+    std::printf("\n100'000 nodes shared between threads, 90%% reads\n");
+    bench::concurrent();
+    std::printf("\n16 MiB strings of random letters repeated 1..n times\n");
+    bench::duplicates();
+    std::printf("\n256 MiB file of random letters repeated 1..4 times to /dev/null\n");
+    bench::duplicates_stream();
+    std::printf("\n1'000'000 strings of 1..32 random letters repeated 1..3 times\n");
+    bench::duplicates_batch();
+    std::printf("\nLists of short strings, links form a single random cycle\n");
+    const auto largest = argc > 1 ? std::stoull(argv[1]) : 10000000;
+    for (std::size_t size = 1000000; size <= largest; size *= 10) {
+        bench::compaction(size);
+    }
+    std::remove(bench::FILE_NAME);
+    return 0;
+}
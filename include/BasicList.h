@@ -0,0 +1,461 @@
+#pragma once
+
+#include "NodePool.h"
+#include "SerializationFormat.h"
+#include "Serializer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Serializable Doubly Linked List of arbitrary payloads.
+ *
+ * Explanation for implementation.
+ *  - The list keeps the fake node pointed to by tail and allocates
+ *    nodes from a slab pool like List does. The fake node has no
+ *    payload, so only deserialize() requires T to be default
+ *    constructible: values are decoded into constructed objects.
+ *  - Payloads are encoded by serializers::Serializer<T>. For bulk
+ *    serializers (trivially copyable types) the choice is made at
+ *    compile time: values are gathered into blocks that are written
+ *    and read with a single call each, otherwise they are encoded one
+ *    by one.
+ *  - The encoding is the number of nodes and the size of a bulk value
+ *    (0 for other serializers) as 8-byte integers, the values and the
+ *    indexes of the "random" nodes plus one (zero if there is no such
+ *    node) as 8-byte integers. Integers are in the native byte order.
+ *  - BasicList<std::string> is specialized: this is List with its own
+ *    formats, payload arena and journal.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+template <typename T>
+class BasicList
+{
+    using Serializer = serializers::Serializer<T>;
+
+    struct Link
+    {
+        Link * m_previous = nullptr;
+        Link * m_next = nullptr;
+        Link * m_random = nullptr;
+    };
+
+    struct Node : Link
+    {
+        template <typename... Args>
+        explicit Node(Args &&... args)
+            : m_data(std::forward<Args>(args)...)
+        {
+        }
+
+        T m_data;
+    };
+
+public:
+    BasicList()
+        : m_head(&m_tail)
+    {
+    }
+
+    ~BasicList() { clear(); }
+
+    BasicList(const BasicList &) = delete;
+    BasicList & operator=(const BasicList &) = delete;
+
+    /**
+     * Iterator generalization (abstraction that does not take into account constness).
+     */
+    template <typename U>
+    struct IteratorT
+    {
+        friend class BasicList;
+        template <typename>
+        friend struct IteratorT;
+
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::remove_const_t<U>;
+        using reference = U &;
+        using pointer = U *;
+
+        /**
+         * Constructor that allows you to cast a non-const iterator to a const iterator.
+         */
+        template <typename V, typename = std::enable_if_t<std::is_const_v<U> && !std::is_const_v<V>>>
+        IteratorT(const IteratorT<V> & iterator)
+            : m_list(iterator.m_list)
+            , m_pointer(iterator.m_pointer)
+        {
+        }
+
+        pointer operator->() const { return &static_cast<Node *>(m_pointer)->m_data; }
+        reference operator*() const { return static_cast<Node *>(m_pointer)->m_data; }
+
+        /**
+         * Moves to next in "random" order.
+         *
+         * @return iterator to the next in "random" order.
+         */
+        IteratorT & move()
+        {
+            m_pointer = next(m_pointer);
+            return *this;
+        }
+
+        /**
+         * @return iterator to the next in "random" order.
+         */
+        IteratorT next() const { return IteratorT{m_list, next(m_pointer)}; }
+
+        /**
+         * Updates "random" order.
+         */
+        void link(const IteratorT & random) const
+        {
+            m_pointer->m_random = random.m_pointer == &m_list->m_tail ? nullptr : random.m_pointer;
+        }
+
+        IteratorT & operator++()
+        {
+            m_pointer = m_pointer->m_next;
+            return *this;
+        }
+
+        IteratorT operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        IteratorT & operator--()
+        {
+            m_pointer = m_pointer->m_previous;
+            return *this;
+        }
+
+        IteratorT operator--(int)
+        {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const IteratorT & lhs, const IteratorT & rhs) { return lhs.m_pointer == rhs.m_pointer; }
+        friend bool operator!=(const IteratorT & lhs, const IteratorT & rhs) { return !(lhs == rhs); }
+
+    private:
+        explicit IteratorT(BasicList * list, Link * pointer)
+            : m_list(list)
+            , m_pointer(pointer)
+        {
+        }
+
+        Link * next(Link * current) const noexcept { return current->m_random ? current->m_random : &m_list->m_tail; }
+
+        BasicList * m_list;
+        Link * m_pointer;
+    };
+
+    using Iterator = IteratorT<T>;
+    using ConstIterator = IteratorT<const T>;
+
+    /**
+     * Complexity: O(1)
+     * @return true is the list has no elements.
+     */
+    bool empty() const noexcept { return size() == 0; }
+    /**
+     * Complexity: O(1)
+     * @return the number of elements in the list.
+     */
+    std::size_t size() const noexcept { return m_size; }
+
+    /**
+     * Constructs an element before position.
+     * Complexity: O(1)
+     *
+     * @param position iterator before which the element will be inserted.
+     * @param args arguments forwarded to the constructor of T.
+     * @return iterator to the inserted element.
+     */
+    template <typename... Args>
+    Iterator emplace(ConstIterator position, Args &&... args)
+    {
+        auto * node = m_pool.create(std::forward<Args>(args)...);
+        auto * next = position.m_pointer;
+        node->m_next = next;
+        node->m_previous = next->m_previous;
+        (node->m_previous ? node->m_previous->m_next : m_head) = node;
+        next->m_previous = node;
+        ++m_size;
+        return Iterator{this, node};
+    }
+
+    /**
+     * Inserts data before position.
+     * Complexity: O(1)
+     *
+     * @param position iterator before which the data will be inserted.
+     * @param data data to insert.
+     * @return iterator to the inserted element.
+     */
+    Iterator insert(ConstIterator position, const T & data) { return emplace(position, data); }
+    Iterator insert(ConstIterator position, T && data) { return emplace(position, std::move(data)); }
+
+    /**
+     * Prepends the given data to the beginning of the list.
+     * Complexity: O(1)
+     *
+     * @param data data to insert.
+     * @return iterator to the inserted element.
+     */
+    Iterator push_front(T data) { return emplace(begin(), std::move(data)); }
+    /**
+     * Appends the given data to the ending of the list.
+     * Complexity: O(1)
+     *
+     * @param data data to insert.
+     * @return iterator to the inserted element.
+     */
+    Iterator push_back(T data) { return emplace(end(), std::move(data)); }
+
+    /**
+     * Removes the data at position.
+     * Complexity: O(1)
+     *
+     * @param position iterator to the element to remove.
+     * @return iterator following the removed element.
+     */
+    Iterator erase(ConstIterator position)
+    {
+        auto * node = position.m_pointer;
+        auto * next = node->m_next;
+        next->m_previous = node->m_previous;
+        (node->m_previous ? node->m_previous->m_next : m_head) = next;
+        m_pool.destroy(static_cast<Node *>(node));
+        --m_size;
+        return Iterator{this, next};
+    }
+
+    /**
+     * Removes the data at the beginning of the list.
+     * Complexity: O(1)
+     *
+     * @return iterator following the removed element.
+     */
+    Iterator pop_front() { return erase(begin()); }
+    /**
+     * Removes the data at the ending of the list.
+     * Complexity: O(1)
+     *
+     * @return iterator following the removed element.
+     */
+    Iterator pop_back() { return erase(std::prev(end())); }
+
+    /**
+     * Erases all elements from the list and releases the memory of the nodes.
+     * Complexity: O(n) if T is not trivially destructible, else - O(number of slabs)
+     */
+    void clear() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (Link * node = m_head; node != &m_tail;) {
+                auto * next = node->m_next;
+                static_cast<Node *>(node)->~Node();
+                node = next;
+            }
+        }
+        m_pool.release();
+        m_head = &m_tail;
+        m_tail.m_previous = nullptr;
+        m_size = 0;
+    }
+
+    Iterator begin() noexcept { return Iterator{this, m_head}; }
+    ConstIterator begin() const noexcept { return ConstIterator{const_cast<BasicList *>(this), m_head}; }
+    Iterator end() noexcept { return Iterator{this, &m_tail}; }
+    ConstIterator end() const noexcept { return ConstIterator{const_cast<BasicList *>(this), &m_tail}; }
+
+    /**
+     * Serializes a list and writes the result to a binary file.
+     * Complexity: O(n)
+     *
+     * @return 0 if list serialized successfully, else - non zero error code.
+     */
+    int serialize(file_ptr_t file) const
+    {
+        if (!file) {
+            return -1;
+        }
+        io::FileSink sink(file);
+        return serialize(sink);
+    }
+
+    /**
+     * Serializes a list and writes the result to a sink.
+     * Complexity: O(n)
+     *
+     * @return 0 if list serialized successfully, else - non zero error code.
+     */
+    int serialize(io::Sink & sink) const
+    {
+        format::Writer writer(sink);
+        char header[HEADER_SIZE];
+        format::put_u64(header, m_size);
+        format::put_u64(header + 8, ELEMENT_SIZE);
+        writer.write(header, sizeof(header));
+
+        // Positions of the nodes by the numbers of their slots in the pool
+        std::vector<std::uint64_t> positions(m_pool.capacity());
+        std::uint64_t position = 0;
+        for (const Link * node = m_head; node != &m_tail; node = node->m_next) {
+            positions[m_pool.slot(static_cast<const Node *>(node))] = position++;
+        } // O(n log(number of slabs))
+
+        if constexpr (Serializer::BULK) {
+            std::vector<T> block;
+            block.reserve(std::min<std::size_t>(m_size, BLOCK_SIZE));
+            for (const Link * node = m_head; node != &m_tail; node = node->m_next) {
+                block.push_back(static_cast<const Node *>(node)->m_data);
+                if (block.size() == BLOCK_SIZE || node->m_next == &m_tail) {
+                    writer.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(T));
+                    block.clear();
+                }
+            }
+        }
+        else {
+            for (const Link * node = m_head; node != &m_tail; node = node->m_next) {
+                Serializer::serialize(static_cast<const Node *>(node)->m_data, writer);
+            }
+        } // O(n)
+
+        std::vector<std::uint64_t> randoms;
+        randoms.reserve(std::min<std::size_t>(m_size, BLOCK_SIZE));
+        for (const Link * node = m_head; node != &m_tail; node = node->m_next) {
+            const auto * random = static_cast<const Node *>(node->m_random);
+            randoms.push_back(random ? positions[m_pool.slot(random)] + 1 : 0);
+            if (randoms.size() == BLOCK_SIZE || node->m_next == &m_tail) {
+                writer.write(reinterpret_cast<const char *>(randoms.data()), randoms.size() * sizeof(std::uint64_t));
+                randoms.clear();
+            }
+        } // O(n log(number of slabs))
+        return writer.flush() ? 0 : 1;
+    }
+
+    /**
+     * Deserializes the list according to the data from the binary file.
+     * The list is left unchanged on failure.
+     * Complexity: O(n)
+     *
+     * @return 0 if list deserialized successfully, else - non zero error code.
+     */
+    int deserialize(file_ptr_t file)
+    {
+        if (!file) {
+            return -1;
+        }
+        io::FileSource source(file);
+        return deserialize(source);
+    }
+
+    /**
+     * Deserializes the list according to the data from a source.
+     * Complexity: O(n)
+     *
+     * @return 0 if list deserialized successfully, else - non zero error code.
+     */
+    int deserialize(io::Source & source)
+    {
+        const auto available = source.remaining();
+        format::Reader reader(source);
+        char header[HEADER_SIZE];
+        if (!reader.read(header, sizeof(header))) {
+            return 1;
+        }
+        const auto count = format::get_integer<std::uint64_t>(header);
+        if (format::get_integer<std::uint64_t>(header + 8) != ELEMENT_SIZE) {
+            return 2;
+        }
+        // Every node takes at least the index of the "random" node
+        if (available != format::UNKNOWN_SIZE && count > available / (sizeof(std::uint64_t) + ELEMENT_SIZE)) {
+            return 1;
+        }
+
+        BasicList list;
+        std::vector<Link *> nodes;
+        // The count of a source of unknown size is trusted only as far as nodes arrive
+        nodes.reserve(std::min<std::uint64_t>(count, BLOCK_SIZE));
+        if constexpr (Serializer::BULK) {
+            std::vector<T> block;
+            for (std::uint64_t first = 0; first < count; first += block.size()) {
+                block.resize(std::min<std::uint64_t>(count - first, BLOCK_SIZE));
+                if (!reader.read(reinterpret_cast<char *>(block.data()), block.size() * sizeof(T))) {
+                    return 1;
+                }
+                for (const auto & value : block) {
+                    nodes.push_back(list.emplace(list.end(), value).m_pointer);
+                }
+            }
+        }
+        else {
+            for (std::uint64_t i = 0; i < count; ++i) {
+                T value;
+                if (!Serializer::deserialize(value, reader)) {
+                    return 1;
+                }
+                nodes.push_back(list.emplace(list.end(), std::move(value)).m_pointer);
+            }
+        } // O(n)
+
+        std::vector<std::uint64_t> randoms;
+        for (std::uint64_t first = 0; first < count; first += randoms.size()) {
+            randoms.resize(std::min<std::uint64_t>(count - first, BLOCK_SIZE));
+            if (!reader.read(reinterpret_cast<char *>(randoms.data()), randoms.size() * sizeof(std::uint64_t))) {
+                return 1;
+            }
+            for (std::size_t i = 0; i < randoms.size(); ++i) {
+                const auto random = randoms[i];
+                if (random > count) {
+                    return 1;
+                }
+                nodes[first + i]->m_random = random == 0 ? nullptr : nodes[random - 1];
+            }
+        } // O(n)
+
+        clear();
+        m_pool = std::move(list.m_pool);
+        if (list.m_head != &list.m_tail) {
+            m_head = list.m_head;
+            m_head->m_previous = nullptr;
+            m_tail.m_previous = list.m_tail.m_previous;
+            m_tail.m_previous->m_next = &m_tail;
+        }
+        m_size = std::exchange(list.m_size, 0);
+        list.m_head = &list.m_tail;
+        list.m_tail.m_previous = nullptr;
+        return 0;
+    }
+
+private:
+    /**
+     * The number of values gathered for a single write or read.
+     */
+    static constexpr std::size_t BLOCK_SIZE = 1 << 12;
+    static constexpr std::size_t HEADER_SIZE = 16;
+    static constexpr std::uint64_t ELEMENT_SIZE = Serializer::BULK ? sizeof(T) : 0;
+
+    NodePool<Node> m_pool;
+    mutable Link m_tail;
+    Link * m_head;
+    std::size_t m_size = 0;
+};
+
+} // namespace solution
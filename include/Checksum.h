@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * CRC-32C (Castagnoli) checksums.
+ *
+ * Explanation for implementation.
+ *  - The implementation is chosen once at runtime: the crc32 instruction
+ *    of SSE 4.2 on x86-64 and of the CRC extension on ARMv8 process
+ *    8 bytes per instruction, other processors use tables.
+ *  - The portable implementation reads 8 bytes at a time from 8 tables
+ *    (slicing-by-8), the tables are computed at compile time.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+namespace solution::checksum {
+
+/**
+ * Complexity: O(size)
+ *
+ * @param crc the checksum of the preceding data, so the checksum may be computed piece by piece.
+ * @return the checksum of the data.
+ */
+std::uint32_t crc32c(const char * data, std::size_t size, std::uint32_t crc = 0);
+
+/**
+ * The portable implementation of crc32c(), it gives the same results.
+ */
+std::uint32_t crc32c_portable(const char * data, std::size_t size, std::uint32_t crc = 0);
+
+/**
+ * @return true if crc32c() uses the instructions of the processor.
+ */
+bool accelerated();
+
+} // namespace solution::checksum
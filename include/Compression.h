@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Block compression of the LZ77 family.
+ *
+ * A block is a sequence of commands, each command is a token, literals and
+ * a match: the high half of the token is the number of literals, the low
+ * half is the length of the match minus MIN_MATCH. The value 15 of a half
+ * is continued by bytes that are added to it until a byte other than 255.
+ * The literals are followed by u16 little-endian distance to the beginning
+ * of the match. The last command has literals only, it ends the block.
+ *
+ * Explanation for implementation.
+ *  - Blocks are independent, so they are compressed and decompressed
+ *    in parallel and any of them is decoded without the others.
+ *  - The compressor finds matches through a small hash table of
+ *    positions of 4-byte sequences and takes the first match (greedy
+ *    parsing). It skips faster over incompressible data.
+ *  - The decompressor checks every length and distance, so malformed
+ *    input is rejected and never read or written out of bounds.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+namespace solution::lz {
+
+constexpr std::size_t MIN_MATCH = 4;
+
+/**
+ * Complexity: O(1)
+ * @return the maximal size of the compressed block.
+ */
+constexpr std::size_t bound(std::size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/**
+ * Compresses a block.
+ * Complexity: O(size)
+ *
+ * @param in the data.
+ * @param size the size of the data.
+ * @param out buffer of bound(size) bytes.
+ * @return the size of the compressed block.
+ */
+std::size_t compress(const char * in, std::size_t size, char * out);
+
+/**
+ * Decompresses a block.
+ * Complexity: O(size)
+ *
+ * @param in the compressed block.
+ * @param size the size of the compressed block.
+ * @param out buffer of capacity bytes.
+ * @param capacity the size of the decompressed data.
+ * @return false if the block is malformed or is not decompressed into exactly capacity bytes.
+ */
+bool decompress(const char * in, std::size_t size, char * out, std::size_t capacity);
+
+} // namespace solution::lz
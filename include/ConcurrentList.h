@@ -0,0 +1,316 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Doubly Linked List of strings with "random" links that is shared between threads.
+ *
+ * Explanation for implementation.
+ *  - Readers never take locks. A reader holds a Guard while it keeps
+ *    iterators, erased nodes are reclaimed only after every Guard
+ *    that could have seen them is released (epoch-based reclamation).
+ *  - Writers lock only the nodes around the change: insert() locks
+ *    the neighbours of the new node, erase() locks the node and its
+ *    neighbours. Locks are always taken from the head to the tail, so
+ *    writers in different parts of the list do not wait for each other.
+ *  - Erased nodes keep their links, so a reader standing on an erased
+ *    node still reaches the rest of the list.
+ *  - Nodes are never returned to the system before the list is
+ *    destroyed, reclaimed nodes are reused. A "random" link stores the
+ *    number of the node and the generation of its contents, so a link
+ *    to an erased node is seen as a link to end() instead of a dangling
+ *    pointer.
+ *  - Payloads are immutable: they are written before a node is
+ *    published and destroyed after it is reclaimed.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class ConcurrentList
+{
+    struct Node;
+
+public:
+    /**
+     * The limit of threads simultaneously holding guards, further threads wait for a free place.
+     */
+    static constexpr std::size_t MAX_GUARDS = 128;
+
+    ConcurrentList();
+    ~ConcurrentList();
+
+    ConcurrentList(const ConcurrentList &) = delete;
+    ConcurrentList & operator=(const ConcurrentList &) = delete;
+
+    /**
+     * Protects the nodes seen by the owning thread from reclamation.
+     * Iterators stay valid while the guard that was alive at the time they
+     * were obtained is alive. Guards of a thread nested in each other take
+     * a single place, as do the guards taken by insert() and erase().
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(const ConcurrentList & list);
+        ~Guard();
+
+        Guard(const Guard &) = delete;
+        Guard & operator=(const Guard &) = delete;
+
+    private:
+        const ConcurrentList & m_list;
+        std::size_t m_slot;
+    };
+
+    class ConstIterator
+    {
+        friend class ConcurrentList;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::string;
+        using reference = const std::string &;
+        using pointer = const std::string *;
+
+        ConstIterator() = default;
+
+        reference operator*() const { return m_node->m_data; }
+        pointer operator->() const { return &m_node->m_data; }
+
+        ConstIterator & operator++()
+        {
+            m_node = m_node->m_next.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        ConstIterator & operator--()
+        {
+            m_node = m_node->m_previous.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        /**
+         * Moves to next in "random" order, to end() if there is no such element
+         * or it is erased.
+         *
+         * @return iterator to the next in "random" order.
+         */
+        ConstIterator & move()
+        {
+            m_node = m_list->resolve(m_node->m_random.load(std::memory_order_acquire));
+            return *this;
+        }
+
+        /**
+         * @return iterator to the next in "random" order.
+         */
+        ConstIterator next() const
+        {
+            auto result = *this;
+            return result.move();
+        }
+
+        /**
+         * @return true if the element was erased after the iterator had been obtained.
+         */
+        bool erased() const noexcept { return !alive(m_node->m_generation.load(std::memory_order_acquire)); }
+
+        bool operator==(const ConstIterator & other) const noexcept { return m_node == other.m_node; }
+        bool operator!=(const ConstIterator & other) const noexcept { return m_node != other.m_node; }
+
+    private:
+        ConstIterator(const ConcurrentList * list, Node * node)
+            : m_list(list)
+            , m_node(node)
+        {
+        }
+
+        const ConcurrentList * m_list = nullptr;
+        Node * m_node = nullptr;
+    };
+
+    /**
+     * Complexity: O(1)
+     * @return iterator to the first element, the calling thread must hold a Guard.
+     */
+    ConstIterator begin() const noexcept { return {this, m_head.m_next.load(std::memory_order_acquire)}; }
+    /**
+     * Complexity: O(1)
+     * @return iterator to the element following the last one.
+     */
+    ConstIterator end() const noexcept { return {this, &m_tail}; }
+
+    /**
+     * Inserts an element before position.
+     * Complexity: O(1) if there are no writers around position
+     *
+     * @param position iterator obtained under a Guard held by the calling thread.
+     * @param data payload.
+     * @return iterator to the inserted element, end() if position was erased.
+     */
+    ConstIterator insert(ConstIterator position, std::string data);
+    /**
+     * Inserts an element before the first one, which may be erased concurrently.
+     * Complexity: O(1) if there are no writers around the head
+     *
+     * @return iterator to the inserted element.
+     */
+    ConstIterator push_front(std::string data);
+    ConstIterator push_back(std::string data) { return insert(end(), std::move(data)); }
+
+    /**
+     * Erases an element, "random" links to it start to lead to end().
+     * Complexity: O(1) if there are no writers around position
+     *
+     * @param position iterator to an element obtained under a Guard held by the calling thread.
+     * @return false if the element has been already erased by another thread.
+     */
+    bool erase(ConstIterator position);
+
+    /**
+     * Updates "random" order of the element.
+     * Complexity: O(1)
+     *
+     * @param position iterator to an element.
+     * @param random iterator to any element or end().
+     */
+    void link(ConstIterator position, ConstIterator random) noexcept;
+
+    /**
+     * Complexity: O(1)
+     * @return the number of elements, approximate while writers are active.
+     */
+    std::size_t size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    /**
+     * Mutual exclusion of the writers around a node.
+     */
+    class SpinLock
+    {
+    public:
+        void lock() noexcept;
+        void unlock() noexcept { m_flag.clear(std::memory_order_release); }
+
+    private:
+        std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+    };
+
+    struct Node
+    {
+        std::atomic<Node *> m_previous{nullptr};
+        std::atomic<Node *> m_next{nullptr};
+        /**
+         * The generation of the target in the high half, the number of the target plus one
+         * in the low half, zero if there is no target.
+         */
+        std::atomic<std::uint64_t> m_random{0};
+        /**
+         * Odd while the node is in the list, increased when it is inserted and erased.
+         */
+        std::atomic<std::uint32_t> m_generation{0};
+        std::uint32_t m_number = 0;
+        SpinLock m_lock;
+        std::string m_data;
+    };
+
+    static bool alive(std::uint32_t generation) noexcept { return generation % 2 == 1; }
+
+    struct alignas(64) GuardSlot
+    {
+        /**
+         * The epoch shifted left by one with the lowest bit set, zero if the slot is free.
+         */
+        std::atomic<std::uint64_t> m_state{0};
+    };
+
+    struct Retired
+    {
+        Node * m_node;
+        std::uint64_t m_epoch;
+    };
+
+    std::size_t enter() const;
+    void leave(std::size_t slot) const noexcept;
+
+    /**
+     * Locks the node before position and position itself.
+     *
+     * @return the node before position, nullptr if position is erased (nothing is locked then).
+     */
+    static Node * lock_previous(Node * position) noexcept;
+    /**
+     * Links the created node before position.
+     *
+     * @return false if position is erased (the node is not linked then).
+     */
+    bool link_before(Node * position, Node * node) noexcept;
+
+    Node * create(std::string data);
+    void retire(Node * node);
+    /**
+     * Advances the epoch if all guards have seen the current one and reuses
+     * the nodes that have been erased two epochs ago.
+     */
+    void reclaim();
+
+    Node * node(std::uint32_t number) const noexcept;
+    Node * resolve(std::uint64_t random) const noexcept;
+
+    mutable Node m_head;
+    mutable Node m_tail;
+    std::atomic<std::size_t> m_size{0};
+
+    std::atomic<std::uint64_t> m_epoch{0};
+    std::unique_ptr<GuardSlot[]> m_guards;
+
+    /**
+     * Nodes are kept in chunks of growing sizes: the chunk k holds
+     * FIRST_CHUNK_SIZE * 2^k nodes, so a number is mapped to its node in O(1)
+     * without synchronization.
+     */
+    static constexpr std::size_t FIRST_CHUNK_SIZE = 64;
+    static constexpr std::size_t MAX_CHUNKS = 26;
+    std::array<std::atomic<Node *>, MAX_CHUNKS> m_chunks{};
+    std::array<std::unique_ptr<Node[]>, MAX_CHUNKS> m_storage;
+
+    /**
+     * Protects the allocation and reclamation of nodes.
+     */
+    std::mutex m_mutex;
+    std::vector<Node *> m_free;
+    std::vector<Retired> m_retired;
+    std::uint32_t m_allocated = 0;
+
+    /**
+     * The number of erased nodes that triggers reclamation.
+     */
+    static constexpr std::size_t RECLAIM_THRESHOLD = 64;
+};
+
+} // namespace solution
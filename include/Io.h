@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace solution {
+
+using file_ptr_t = FILE *;
+
+/**
+ * Destinations and origins of serialized lists.
+ *
+ * Explanation for implementation.
+ *  - Serialization only appends bytes to a Sink and deserialization
+ *    only consumes bytes of a Source in order, so both are a single
+ *    virtual call per large block (the callers buffer small pieces).
+ *  - Sources may take back the bytes that were read ahead but not
+ *    consumed (unread()), so the data that follows a list in a file
+ *    stays readable.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+namespace io {
+
+/**
+ * Returned by Source::remaining() if the size is not known.
+ */
+constexpr std::uint64_t UNKNOWN_SIZE = std::numeric_limits<std::uint64_t>::max();
+
+class Sink
+{
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * Writes all bytes.
+     *
+     * @return false if the write has failed.
+     */
+    virtual bool write(const char * data, std::size_t size) = 0;
+
+    /**
+     * Called once a list is written completely.
+     *
+     * @return false if some write has failed.
+     */
+    virtual bool flush() { return true; }
+};
+
+class Source
+{
+public:
+    virtual ~Source() = default;
+
+    /**
+     * Reads up to size bytes, less only at the end of the source.
+     *
+     * @return the number of bytes read.
+     */
+    virtual std::size_t read(char * data, std::size_t size) = 0;
+
+    /**
+     * @return the number of bytes left or UNKNOWN_SIZE.
+     */
+    virtual std::uint64_t remaining() { return UNKNOWN_SIZE; }
+
+    /**
+     * Returns the last count read bytes to the source if it is possible.
+     */
+    virtual void unread(std::size_t /* count */) {}
+};
+
+/**
+ * Adapters of stdio files, the file stays open.
+ */
+class FileSink final : public Sink
+{
+public:
+    explicit FileSink(file_ptr_t file)
+        : m_file(file)
+    {
+    }
+
+    bool write(const char * data, std::size_t size) override;
+
+private:
+    file_ptr_t m_file;
+};
+
+class FileSource final : public Source
+{
+public:
+    explicit FileSource(file_ptr_t file)
+        : m_file(file)
+    {
+    }
+
+    std::size_t read(char * data, std::size_t size) override;
+    std::uint64_t remaining() override;
+    void unread(std::size_t count) override;
+
+private:
+    file_ptr_t m_file;
+};
+
+/**
+ * Adapters of file descriptors (files, pipes, sockets), the descriptor stays open.
+ */
+class FdSink final : public Sink
+{
+public:
+    explicit FdSink(int fd)
+        : m_fd(fd)
+    {
+    }
+
+    bool write(const char * data, std::size_t size) override;
+
+private:
+    int m_fd;
+};
+
+class FdSource final : public Source
+{
+public:
+    explicit FdSource(int fd)
+        : m_fd(fd)
+    {
+    }
+
+    std::size_t read(char * data, std::size_t size) override;
+    std::uint64_t remaining() override;
+    void unread(std::size_t count) override;
+
+private:
+    int m_fd;
+};
+
+/**
+ * Appends the bytes to a growable buffer, for example, to send it over the network.
+ */
+class BufferSink final : public Sink
+{
+public:
+    explicit BufferSink(std::vector<char> & buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    bool write(const char * data, std::size_t size) override
+    {
+        m_buffer.insert(m_buffer.end(), data, data + size);
+        return true;
+    }
+
+private:
+    std::vector<char> & m_buffer;
+};
+
+/**
+ * Reads the bytes of a contiguous block of memory, which must outlive the source.
+ */
+class MemorySource final : public Source
+{
+public:
+    MemorySource(const char * data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    explicit MemorySource(std::string_view data)
+        : MemorySource(data.data(), data.size())
+    {
+    }
+
+    std::size_t read(char * data, std::size_t size) override;
+    std::uint64_t remaining() override { return m_size - m_position; }
+    void unread(std::size_t count) override { m_position -= count; }
+
+    /**
+     * @return the number of consumed bytes.
+     */
+    std::size_t position() const noexcept { return m_position; }
+
+private:
+    const char * m_data;
+    std::size_t m_size;
+    std::size_t m_position = 0;
+};
+
+} // namespace io
+
+} // namespace solution
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "SerializationFormat.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Random access to the elements of a list serialized in the version 2
+ * without decoding the rest of the file.
+ *
+ * Explanation for implementation.
+ *  - If the list was serialized with an index, open() reads the header,
+ *    the footer and the frame table only. Otherwise the frame table is
+ *    rebuilt by skipping from one frame header to another.
+ *  - An element is fetched by reading its frame, which is cached, so
+ *    reading neighbouring elements does not touch the file again.
+ *  - The indexed list must end the file, since the footer is looked for
+ *    at the end of it.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class ListReader
+{
+public:
+    /**
+     * Element of the serialized list.
+     */
+    struct Element
+    {
+        std::string m_data;
+        /**
+         * Index of the "random" element or NO_RANDOM.
+         */
+        std::uint64_t m_random;
+    };
+
+    static constexpr auto NO_RANDOM = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     * Opens the serialized list that starts at the current position of the file.
+     * The file must stay open while the reader is used.
+     * Complexity: O(number of frames)
+     *
+     * @param file seekable file opened for reading.
+     * @return 0 if the list is opened successfully, else - non zero error code.
+     */
+    int open(file_ptr_t file);
+
+    /**
+     * Complexity: O(1)
+     * @return the number of elements in the list.
+     */
+    std::uint64_t size() const noexcept { return m_header.m_count; }
+    /**
+     * Complexity: O(1)
+     * @return the total size of payloads of the list.
+     */
+    std::uint64_t payload_size() const noexcept { return m_header.m_payload_size; }
+    /**
+     * Complexity: O(1)
+     * @return true if the list was serialized with an index.
+     */
+    bool indexed() const noexcept { return m_header.m_flags & format::FLAG_INDEX; }
+
+    /**
+     * Reads an element.
+     * Complexity: O(log(number of frames) + size of a frame)
+     *
+     * @param index index of the element.
+     * @param element the read element.
+     * @return 0 if the element is read successfully, else - non zero error code.
+     */
+    int read(std::uint64_t index, Element & element);
+
+    /**
+     * Reads a range of elements.
+     * Complexity: O(log(number of frames) + size of the range)
+     *
+     * @param first index of the first element.
+     * @param last index past the last element.
+     * @param elements vector to which the read elements are appended.
+     * @return 0 if the elements are read successfully, else - non zero error code.
+     */
+    int read(std::uint64_t first, std::uint64_t last, std::vector<Element> & elements);
+
+private:
+    /**
+     * Makes the frame that contains the element current.
+     *
+     * @param offset offset of the element in the body of the frame.
+     * @return false on failure.
+     */
+    bool seek(std::uint64_t index, std::uint32_t & offset);
+
+    bool load_frame(std::size_t frame);
+
+    const format::Dictionary * dictionary() const noexcept
+    {
+        return m_header.m_flags & format::FLAG_DICTIONARY ? &m_dictionary : nullptr;
+    }
+
+    file_ptr_t m_file = nullptr;
+    long m_base = 0;
+    format::Header m_header;
+    std::vector<format::FrameEntry> m_frames;
+    long m_offsets = 0;
+    std::vector<char> m_entries;
+    format::Dictionary m_dictionary;
+
+    std::size_t m_frame = 0;
+    std::vector<char> m_body;
+    std::vector<char> m_buffer;
+    bool m_loaded = false;
+};
+
+} // namespace solution
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "SerializationFormat.h"
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Sequential reader of a serialized list (both versions of the format)
+ * that hands out nodes one by one.
+ *
+ * Explanation for implementation.
+ *  - Only the current frame of the version 2 (or the current payload of
+ *    the version 1) is kept in memory, so memory use does not depend on
+ *    the size of the list.
+ *  - Nodes are available through next(), for_each() with a callback or
+ *    an input iterator. The payload of a node is valid until the next
+ *    node is decoded.
+ *  - "Random" indexes are passed as they are stored, bounds are checked
+ *    for the version 2 only (the number of nodes of the version 1 is not
+ *    known in advance).
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class ListStream
+{
+public:
+    /**
+     * Decoded node.
+     */
+    struct Element
+    {
+        std::string_view m_data;
+        /**
+         * Index of the "random" node or NO_RANDOM.
+         */
+        std::uint64_t m_random = NO_RANDOM;
+    };
+
+    static constexpr auto NO_RANDOM = std::numeric_limits<std::uint64_t>::max();
+    static constexpr auto UNKNOWN_SIZE = format::UNKNOWN_SIZE;
+
+    /**
+     * Input iterator over the remaining nodes of the stream.
+     */
+    class Iterator
+    {
+        friend class ListStream;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Element;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        Iterator() = default;
+
+        reference operator*() const { return m_stream->m_element; }
+        pointer operator->() const { return &m_stream->m_element; }
+
+        Iterator & operator++()
+        {
+            if (!m_stream->next(m_stream->m_element)) {
+                m_stream = nullptr;
+            }
+            return *this;
+        }
+
+        friend bool operator==(const Iterator & lhs, const Iterator & rhs)
+        {
+            return lhs.m_stream == rhs.m_stream;
+        }
+
+        friend bool operator!=(const Iterator & lhs, const Iterator & rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        explicit Iterator(ListStream * stream)
+            : m_stream(stream)
+        {
+        }
+
+        ListStream * m_stream = nullptr;
+    };
+
+    /**
+     * Starts reading the list at the current position of the file.
+     *
+     * @return 0 if the beginning of the list is read successfully, else - non zero error code.
+     */
+    int open(file_ptr_t file);
+    /**
+     * Starts reading the list at the current position of the file descriptor.
+     *
+     * @return 0 if the beginning of the list is read successfully, else - non zero error code.
+     */
+    int open(int fd);
+    /**
+     * Starts reading the list at the current position of the source,
+     * which must outlive the stream.
+     *
+     * @return 0 if the beginning of the list is read successfully, else - non zero error code.
+     */
+    int open(io::Source & source);
+
+    /**
+     * Complexity: O(1)
+     * @return the number of nodes or UNKNOWN_SIZE for the version 1.
+     */
+    std::uint64_t size() const noexcept { return m_size; }
+
+    /**
+     * Decodes the next node.
+     * Complexity: amortized O(size of the payload)
+     *
+     * @param element the decoded node.
+     * @return false at the end of the list or on failure (see status()),
+     *         after which the source is no longer used and may be closed.
+     */
+    bool next(Element & element);
+
+    /**
+     * @return 0 if no errors occurred, else - non zero error code.
+     */
+    int status() const noexcept { return m_status; }
+
+    /**
+     * Calls visitor(data, random) for each remaining node.
+     * Complexity: O(n)
+     *
+     * @return 0 if all nodes are read successfully, else - non zero error code.
+     */
+    template <typename Visitor>
+    int for_each(Visitor && visitor)
+    {
+        Element element;
+        while (next(element)) {
+            visitor(element.m_data, element.m_random);
+        }
+        return m_status;
+    }
+
+    /**
+     * Decodes the first remaining node.
+     *
+     * @return an iterator to it.
+     */
+    Iterator begin()
+    {
+        Iterator iterator{this};
+        return ++iterator;
+    }
+
+    Iterator end() noexcept { return {}; }
+
+private:
+    int start();
+
+    /**
+     * Gives the buffered bytes back to the source and stops reading it.
+     */
+    int stop(int status)
+    {
+        m_reader.reset();
+        return m_status = status;
+    }
+
+    bool fail(int status)
+    {
+        stop(status);
+        return false;
+    }
+
+    /**
+     * The adapter of the file or the file descriptor passed to open().
+     */
+    std::unique_ptr<io::Source> m_source;
+    std::optional<format::Reader> m_reader;
+    /**
+     * The size of the source when it was opened, it bounds sizes read from the stream.
+     */
+    std::uint64_t m_available = UNKNOWN_SIZE;
+    int m_status = -1;
+    std::uint16_t m_version = 0;
+    std::uint64_t m_size = UNKNOWN_SIZE;
+    std::uint64_t m_index = 0;
+
+    std::vector<char> m_entries;
+    format::Dictionary m_dictionary;
+    std::uint16_t m_flags = 0;
+    std::vector<char> m_buffer;
+
+    std::vector<char> m_body;
+    const char * m_position = nullptr;
+    std::uint32_t m_records = 0;
+    std::string m_payload;
+
+    Element m_element;
+};
+
+} // namespace solution
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "SerializationFormat.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+namespace solution {
+
+/**
+ * Read-only view of a list serialized in the version 2 with an index.
+ *
+ * Explanation for implementation.
+ *  - The file is mapped into memory and payloads are handed out as
+ *    views of the mapping: nothing is copied and nothing is allocated
+ *    per element, so opening a view takes the same time for any list.
+ *  - Elements are addressed by their indexes. The next element in the
+ *    natural order is found right after the current one, an element
+ *    in "random" order is found through the frame table (binary search)
+ *    and the record offset table of the index.
+ *  - The file is trusted to be produced by List::serialize: records are
+ *    decoded with bounds checks only, a malformed record reads as an
+ *    empty payload without "random" element.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class ListView
+{
+public:
+    ListView() = default;
+    ~ListView();
+
+    ListView(const ListView &) = delete;
+    ListView & operator=(const ListView &) = delete;
+
+    /**
+     * Iterator over the elements of the view, mirrors List::ConstIterator.
+     */
+    class ConstIterator
+    {
+        friend class ListView;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::string_view;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        ConstIterator() = default;
+
+        pointer operator->() const { return &m_data; }
+        reference operator*() const { return m_data; }
+
+        /**
+         * Moves to next in "random" order.
+         *
+         * @return iterator to the next in "random" order.
+         */
+        ConstIterator & move()
+        {
+            *this = next();
+            return *this;
+        }
+
+        /**
+         * @return iterator to the next in "random" order.
+         */
+        ConstIterator next() const { return m_view->at(m_random); }
+
+        ConstIterator & operator++();
+
+        ConstIterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        ConstIterator & operator--()
+        {
+            *this = m_view->at(m_index - 1);
+            return *this;
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const ConstIterator & lhs, const ConstIterator & rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend bool operator!=(const ConstIterator & lhs, const ConstIterator & rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        /**
+         * Decodes the record and remembers where the following one starts.
+         */
+        void decode(const char * record);
+
+        const ListView * m_view = nullptr;
+        std::uint64_t m_index = 0;
+        std::uint64_t m_frame = 0;
+        const char * m_next_record = nullptr;
+        const char * m_frame_end = nullptr;
+        std::string_view m_data;
+        std::uint64_t m_random = 0;
+    };
+
+    /**
+     * Maps the list that starts at the current position of the file.
+     * The file may be closed right after that, the mapping stays valid.
+     * Complexity: O(size of the dictionary)
+     *
+     * @param file file with a list serialized with SerializeOptions::index and without
+     * SerializeOptions::compress, since payloads are read in place. Checksums of the
+     * frames are not verified.
+     * @return 0 if the list is mapped successfully, else - non zero error code.
+     */
+    int open(file_ptr_t file);
+
+    /**
+     * Unmaps the file, all iterators become invalid.
+     */
+    void close() noexcept;
+
+    /**
+     * Complexity: O(1)
+     * @return true is the list has no elements.
+     */
+    bool empty() const noexcept { return size() == 0; }
+    /**
+     * Complexity: O(1)
+     * @return the number of elements in the list.
+     */
+    std::uint64_t size() const noexcept { return m_header.m_count; }
+
+    /**
+     * Complexity: O(1)
+     * @return an iterator to the beginning.
+     */
+    ConstIterator begin() const { return at(0); }
+    /**
+     * Complexity: O(1)
+     * @return an iterator to the end.
+     */
+    ConstIterator end() const { return at(size()); }
+
+    /**
+     * Complexity: O(log(number of frames))
+     * @return an iterator to the element with the index (end() if the index is out of range).
+     */
+    ConstIterator at(std::uint64_t index) const;
+
+private:
+    /**
+     * @return the body of the frame and the end of it.
+     */
+    std::pair<const char *, const char *> frame(std::uint64_t number) const;
+
+    std::uint64_t frame_first(std::uint64_t number) const;
+
+    const format::Dictionary * dictionary() const noexcept
+    {
+        return m_header.m_flags & format::FLAG_DICTIONARY ? &m_dictionary : nullptr;
+    }
+
+    void * m_mapping = nullptr;
+    std::size_t m_mapping_size = 0;
+    const char * m_begin = nullptr;
+    const char * m_end = nullptr;
+    format::Header m_header;
+    const char * m_frames = nullptr;
+    std::uint64_t m_frame_count = 0;
+    const char * m_offsets = nullptr;
+    /**
+     * Views of the mapped dictionary entries.
+     */
+    format::Dictionary m_dictionary;
+};
+
+} // namespace solution
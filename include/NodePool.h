@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Slab allocator for objects of a single type.
+ *
+ * Explanation for implementation.
+ *  - Objects are carved out of large slabs that are allocated with
+ *    geometrically growing sizes, so consecutive allocations lie next
+ *    to each other in memory and the number of calls to the global
+ *    allocator is logarithmic in the number of objects.
+ *  - Destroyed objects are put on an intrusive free list and their
+ *    slots are reused by the following allocations.
+ *  - Every slot has a dense number less than capacity(), which lets
+ *    the owner keep per-object data in plain arrays instead of hash
+ *    maps keyed by pointers.
+ *  - The pool does not track live objects: release() drops all slabs
+ *    at once, so the owner must destroy the objects beforehand (this
+ *    is a no-op for trivially destructible types).
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+template <typename T>
+class NodePool
+{
+public:
+    NodePool() = default;
+
+    NodePool(const NodePool &) = delete;
+    NodePool & operator=(const NodePool &) = delete;
+
+    NodePool(NodePool && other) noexcept
+        : m_slabs(std::move(other.m_slabs))
+        , m_order(std::move(other.m_order))
+        , m_free(std::exchange(other.m_free, nullptr))
+        , m_used(std::exchange(other.m_used, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    NodePool & operator=(NodePool && other) noexcept
+    {
+        m_slabs = std::move(other.m_slabs);
+        m_order = std::move(other.m_order);
+        m_free = std::exchange(other.m_free, nullptr);
+        m_used = std::exchange(other.m_used, 0);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        other.m_slabs.clear();
+        other.m_order.clear();
+        return *this;
+    }
+
+    /**
+     * Constructs an object in a free slot.
+     * Complexity: amortized O(1)
+     *
+     * @param args arguments forwarded to the constructor of T.
+     * @return pointer to the constructed object.
+     */
+    template <typename... Args>
+    T * create(Args &&... args)
+    {
+        auto * slot = allocate();
+        return ::new (static_cast<void *>(slot->m_storage)) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Allocates storage for count objects that lie next to each other like
+     * elements of an array. The caller constructs the objects with placement
+     * new before they are used or destroyed, possibly from several threads.
+     * Complexity: O(1)
+     *
+     * @param count number of objects.
+     * @return pointer to the storage of the first object.
+     */
+    T * allocate(std::size_t count)
+    {
+        static_assert(sizeof(Slot) == sizeof(T), "Slots must be addressable as an array of objects");
+        if (count == 0) {
+            return nullptr;
+        }
+        reserve(count);
+        auto * slots = &m_slabs.back().m_slots[m_used];
+        m_used += count;
+        return reinterpret_cast<T *>(slots);
+    }
+
+    /**
+     * Destroys an object and puts its slot on the free list.
+     * Complexity: O(1)
+     *
+     * @param object pointer to the object created by this pool.
+     */
+    void destroy(T * object) noexcept
+    {
+        object->~T();
+        auto * slot = ::new (static_cast<void *>(object)) Slot;
+        slot->m_next = m_free;
+        m_free = slot;
+    }
+
+    /**
+     * Makes sure that the following count allocations are placed contiguously
+     * (unless there are free slots to reuse).
+     * Complexity: O(1)
+     *
+     * @param count number of objects that will be created.
+     */
+    void reserve(std::size_t count)
+    {
+        if (m_slabs.empty() || m_slabs.back().m_size - m_used < count) {
+            add_slab(std::max(count, next_slab_size()));
+        }
+    }
+
+    /**
+     * Frees all slabs at once. All objects must be destroyed beforehand.
+     * Complexity: O(number of slabs)
+     */
+    void release() noexcept
+    {
+        m_slabs.clear();
+        m_order.clear();
+        m_free = nullptr;
+        m_used = 0;
+        m_capacity = 0;
+    }
+
+    /**
+     * Takes over the slabs of other, its objects stay where they are and get
+     * slots numbered after the slots of this pool. Free slots of other and the
+     * unused rest of the current slab of this pool are reclaimed by release() only.
+     * Complexity: O(number of slabs log(number of slabs))
+     *
+     * @param other pool that becomes empty.
+     */
+    void merge(NodePool && other)
+    {
+        if (&other == this || other.m_slabs.empty()) {
+            return;
+        }
+        for (auto & slab : other.m_slabs) {
+            slab.m_first += m_capacity;
+            m_slabs.push_back(std::move(slab));
+        }
+        for (auto position : other.m_order) {
+            position.m_first += m_capacity;
+            const auto found = std::upper_bound(m_order.begin(), m_order.end(), position.m_begin, [](const Slot * value, const SlabPosition & entry) {
+                return std::less<const Slot *>()(value, entry.m_begin);
+            });
+            m_order.insert(found, position);
+        }
+        m_capacity += other.m_capacity;
+        // The last slab of other becomes the current one
+        m_used = other.m_used;
+        other.release();
+    }
+
+    /**
+     * Complexity: O(log(number of slabs))
+     * @param object pointer to a live object created by this pool.
+     * @return the dense number of the slot of the object, less than capacity().
+     */
+    std::size_t slot(const T * object) const noexcept
+    {
+        const auto * slot = reinterpret_cast<const Slot *>(object);
+        const auto found = std::upper_bound(m_order.begin(), m_order.end(), slot, [](const Slot * value, const SlabPosition & position) {
+            return std::less<const Slot *>()(value, position.m_begin);
+        });
+        const auto & position = *std::prev(found);
+        return position.m_first + static_cast<std::size_t>(slot - position.m_begin);
+    }
+
+    /**
+     * Complexity: O(log(number of slabs))
+     * @param slot the number of a slot of a live object, less than capacity().
+     * @return pointer to the object.
+     */
+    T * at(std::size_t slot) const noexcept
+    {
+        const auto found = std::upper_bound(m_slabs.begin(), m_slabs.end(), slot, [](std::size_t value, const Slab & slab) {
+            return value < slab.m_first;
+        });
+        const auto & slab = *std::prev(found);
+        return reinterpret_cast<T *>(&slab.m_slots[slot - slab.m_first]);
+    }
+
+    /**
+     * Complexity: O(1)
+     * @return the number of slots in all slabs.
+     */
+    std::size_t capacity() const noexcept { return m_capacity; }
+
+private:
+    union Slot
+    {
+        Slot * m_next;
+        alignas(T) unsigned char m_storage[sizeof(T)];
+    };
+
+    struct Slab
+    {
+        std::unique_ptr<Slot[]> m_slots;
+        std::size_t m_size;
+        /**
+         * The number of the first slot of the slab.
+         */
+        std::size_t m_first;
+    };
+
+    struct SlabPosition
+    {
+        const Slot * m_begin;
+        std::size_t m_first;
+    };
+
+    Slot * allocate()
+    {
+        if (m_free) {
+            auto * slot = m_free;
+            m_free = slot->m_next;
+            return slot;
+        }
+        if (m_slabs.empty() || m_used == m_slabs.back().m_size) {
+            add_slab(next_slab_size());
+        }
+        return &m_slabs.back().m_slots[m_used++];
+    }
+
+    std::size_t next_slab_size() const noexcept
+    {
+        return m_slabs.empty() ? MIN_SLAB_SIZE : std::min(m_slabs.back().m_size * 2, MAX_SLAB_SIZE);
+    }
+
+    void add_slab(std::size_t size)
+    {
+        m_slabs.push_back(Slab{std::unique_ptr<Slot[]>(new Slot[size]), size, m_capacity});
+        const SlabPosition position{m_slabs.back().m_slots.get(), m_capacity};
+        const auto found = std::upper_bound(m_order.begin(), m_order.end(), position.m_begin, [](const Slot * value, const SlabPosition & other) {
+            return std::less<const Slot *>()(value, other.m_begin);
+        });
+        m_order.insert(found, position);
+        m_capacity += size;
+        m_used = 0;
+    }
+
+    std::vector<Slab> m_slabs;
+    /**
+     * Slabs sorted by address.
+     */
+    std::vector<SlabPosition> m_order;
+    Slot * m_free = nullptr;
+    std::size_t m_used = 0;
+    std::size_t m_capacity = 0;
+
+    static constexpr std::size_t MIN_SLAB_SIZE = 64;
+    static constexpr std::size_t MAX_SLAB_SIZE = 1 << 16;
+};
+
+} // namespace solution
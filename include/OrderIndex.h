@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Sequence of dense identifiers with positional access in O(log n).
+ *
+ * Explanation for implementation.
+ *  - This is an implicit treap: the position of an identifier is the
+ *    number of identifiers before it in the in-order traversal, so no
+ *    keys are stored and insertions shift the following positions for
+ *    free.
+ *  - Identifiers are the numbers of slots of a NodePool, so the fields
+ *    of the tree are kept in plain arrays indexed by them and the
+ *    position of an identifier is found by climbing parent links.
+ *  - Fields are 32-bit, 20 bytes per identifier.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class OrderIndex
+{
+public:
+    /**
+     * The limit of identifiers.
+     */
+    static constexpr std::size_t MAX_SIZE = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * Replaces the sequence.
+     * Complexity: O(n)
+     *
+     * @param ids identifiers in order, each one less than MAX_SIZE.
+     */
+    void assign(const std::vector<std::size_t> & ids);
+
+    /**
+     * Inserts an identifier that is not in the sequence.
+     * Complexity: O(log n) on average, amortized O(id) if the arrays grow
+     *
+     * @param position the number of identifiers before it.
+     * @param id identifier less than MAX_SIZE.
+     */
+    void insert(std::size_t position, std::size_t id);
+
+    /**
+     * Removes an identifier.
+     * Complexity: O(log n) on average
+     */
+    void erase(std::size_t id);
+    /**
+     * Removes the identifiers at positions [first, last).
+     * Complexity: O(log n) on average
+     */
+    void erase(std::size_t first, std::size_t last);
+
+    /**
+     * Complexity: O(log n) on average
+     * @return the identifier at position.
+     */
+    std::size_t at(std::size_t position) const noexcept;
+    /**
+     * Complexity: O(log n) on average
+     * @return the position of the identifier.
+     */
+    std::size_t position(std::size_t id) const noexcept;
+
+    /**
+     * Complexity: O(1)
+     * @return the number of identifiers.
+     */
+    std::size_t size() const noexcept { return count(m_root); }
+
+    void clear() noexcept { m_root = NIL; }
+
+private:
+    static constexpr std::uint32_t NIL = std::numeric_limits<std::uint32_t>::max();
+
+    struct Split
+    {
+        std::uint32_t m_left;
+        std::uint32_t m_right;
+    };
+
+    std::size_t count(std::uint32_t node) const noexcept { return node == NIL ? 0 : m_count[node]; }
+    void update(std::uint32_t node) noexcept;
+    void reserve(std::size_t size);
+    std::uint32_t priority() noexcept;
+
+    /**
+     * Splits the subtree into the first count identifiers and the other ones.
+     */
+    Split split(std::uint32_t node, std::size_t count) noexcept;
+    std::uint32_t merge(std::uint32_t left, std::uint32_t right) noexcept;
+
+    std::vector<std::uint32_t> m_left;
+    std::vector<std::uint32_t> m_right;
+    std::vector<std::uint32_t> m_parent;
+    std::vector<std::uint32_t> m_count;
+    std::vector<std::uint32_t> m_priority;
+    std::uint32_t m_root = NIL;
+    std::uint64_t m_random = 0x9e3779b97f4a7c15u;
+};
+
+} // namespace solution
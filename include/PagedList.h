@@ -0,0 +1,349 @@
+#pragma once
+
+#include "Io.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Doubly Linked List of strings with "random" links that is kept in files
+ * and only partially cached in memory, for lists larger than RAM.
+ *
+ * Explanation for implementation.
+ *  - Nodes are records of a fixed size in pages of the file of nodes,
+ *    a node is addressed by its number, so the page and the offset of
+ *    a node are computed without any lookup. Erased nodes are chained
+ *    through their records and reused.
+ *  - Payloads are appended to the file of payloads and may span
+ *    several pages. Space of erased payloads is not reused until the
+ *    list is cleared or deserialized.
+ *  - serialize() numbers the nodes in the file of positions, indexed by
+ *    the numbers of nodes like the records. The positions stay current
+ *    until the list is changed, and the pages of nodes are not written
+ *    by serialize() at all.
+ *  - Pages are cached in a fixed number of frames that fit into the
+ *    memory budget and evicted in LRU order, dirty pages are written
+ *    back on eviction and by flush(). Every operation copies records
+ *    and payloads out of the cache, so a single frame is enough.
+ *  - The files are the persistent form of the list: flush() writes only
+ *    the changed pages and open() continues where the list was left.
+ *    serialize() and deserialize() convert from and to the format of
+ *    List streaming node by node.
+ *  - Files are written in the byte order of the machine, they are
+ *    storage rather than an exchange format.
+ *  - I/O errors cannot be returned by iterators, so the first error is
+ *    kept and reported by status() and flush().
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class PagedList
+{
+public:
+    static constexpr std::size_t PAGE_SIZE = 1 << 16;
+    static constexpr std::size_t DEFAULT_MEMORY = std::size_t{64} << 20;
+
+    PagedList() = default;
+    ~PagedList();
+
+    PagedList(const PagedList &) = delete;
+    PagedList & operator=(const PagedList &) = delete;
+
+    /**
+     * Iterator over the elements, mirrors List::Iterator. The payload is read
+     * when the iterator is dereferenced and stays valid until it is moved.
+     */
+    class Iterator
+    {
+        friend class PagedList;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::string;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        Iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const { return &**this; }
+
+        Iterator & operator++();
+        Iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        Iterator & operator--();
+        Iterator operator--(int)
+        {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        /**
+         * Moves to next in "random" order.
+         *
+         * @return iterator to the next in "random" order.
+         */
+        Iterator & move();
+
+        /**
+         * @return iterator to the next in "random" order.
+         */
+        Iterator next() const
+        {
+            auto result = *this;
+            return result.move();
+        }
+
+        /**
+         * Updates "random" order.
+         */
+        void link(const Iterator & random) const { m_list->link(*this, random); }
+
+        friend bool operator==(const Iterator & lhs, const Iterator & rhs)
+        {
+            return lhs.m_node == rhs.m_node;
+        }
+
+        friend bool operator!=(const Iterator & lhs, const Iterator & rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Iterator(PagedList * list, std::uint64_t node)
+            : m_list(list)
+            , m_node(node)
+        {
+        }
+
+        void reset(std::uint64_t node)
+        {
+            m_node = node;
+            m_loaded = false;
+        }
+
+        PagedList * m_list = nullptr;
+        std::uint64_t m_node = NONE;
+        mutable bool m_loaded = false;
+        mutable std::string m_data;
+    };
+
+    using ConstIterator = Iterator;
+
+    /**
+     * Opens the list kept in the files path, path + ".payloads" and
+     * path + ".positions", they are created if they do not exist.
+     * Complexity: O(1)
+     *
+     * @param path path to the file of nodes.
+     * @param memory the memory budget of the page cache in bytes, at least PAGE_SIZE.
+     * @return 0 if the list is opened successfully, else - non zero error code.
+     */
+    int open(const std::string & path, std::size_t memory = DEFAULT_MEMORY);
+
+    /**
+     * Writes the changed pages and the header to the files.
+     * Complexity: O(number of changed pages)
+     *
+     * @return 0 if all changes are written and no errors occurred before, else - non zero error code.
+     */
+    int flush();
+
+    /**
+     * Flushes the list and closes the files, all iterators become invalid.
+     *
+     * @return the result of flush().
+     */
+    int close();
+
+    /**
+     * @return 0 if no errors occurred, else - non zero error code.
+     */
+    int status() const noexcept { return m_status; }
+
+    Iterator begin() noexcept { return {this, m_header.m_first}; }
+    Iterator end() noexcept { return {this, NONE}; }
+
+    /**
+     * Complexity: O(1)
+     * @return the number of elements.
+     */
+    std::size_t size() const noexcept { return m_header.m_size; }
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * Inserts an element before position.
+     * Complexity: O(data.size()) plus reading at most three pages
+     *
+     * @return iterator to the inserted element.
+     */
+    Iterator insert(const Iterator & position, std::string_view data);
+    Iterator push_front(std::string_view data) { return insert(begin(), data); }
+    Iterator push_back(std::string_view data) { return insert(end(), data); }
+
+    /**
+     * Erases an element, "random" links to it become invalid as in List.
+     * Complexity: reading at most three pages
+     *
+     * @return iterator to the following element.
+     */
+    Iterator erase(const Iterator & position);
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(std::prev(end())); }
+
+    /**
+     * Updates "random" order of the element.
+     * Complexity: reading a single page
+     */
+    void link(const Iterator & position, const Iterator & random);
+
+    /**
+     * Removes all elements and truncates the files.
+     * Complexity: O(number of cached pages)
+     */
+    void clear();
+
+    /**
+     * Writes the list in the version 1 of the format of List, without
+     * keeping the list in memory. Pages of nodes are only read, the positions
+     * are written by the first call after the list is modified.
+     * Complexity: O(n) plus reading every page twice in the worst case
+     *
+     * @param sink destination of the serialized list.
+     * @return 0 if the list is serialized successfully, else - non zero error code.
+     */
+    int serialize(io::Sink & sink);
+
+    /**
+     * Replaces the elements with the list read from the source (both versions of
+     * the format of List), without keeping the list in memory. The list is left
+     * empty on failure.
+     * Complexity: O(n)
+     *
+     * @param source source of the serialized list.
+     * @return 0 if the list is deserialized successfully, else - non zero error code.
+     */
+    int deserialize(io::Source & source);
+
+private:
+    static constexpr auto NONE = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::uint32_t NO_FRAME = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * The first page of the file of nodes.
+     */
+    struct Header
+    {
+        char m_magic[8] = {'S', 'L', 'P', 'A', 'G', 'E', 'D', '1'};
+        std::uint64_t m_size = 0;
+        std::uint64_t m_first = NONE;
+        std::uint64_t m_last = NONE;
+        /**
+         * The first erased node, the following ones are chained through m_next.
+         */
+        std::uint64_t m_free = NONE;
+        /**
+         * The number of nodes ever allocated.
+         */
+        std::uint64_t m_nodes = 0;
+        std::uint64_t m_payload_size = 0;
+        /**
+         * Nonzero while the file of positions is current, reset by insert(), erase() and clear().
+         */
+        std::uint64_t m_numbered = 0;
+    };
+
+    struct Record
+    {
+        std::uint64_t m_previous;
+        std::uint64_t m_next;
+        std::uint64_t m_random;
+        std::uint64_t m_payload;
+        std::uint64_t m_length;
+    };
+
+    static constexpr std::size_t RECORDS_PER_PAGE = PAGE_SIZE / sizeof(Record);
+    static constexpr std::size_t POSITIONS_PER_PAGE = PAGE_SIZE / sizeof(std::uint64_t);
+
+    enum File : std::uint64_t
+    {
+        NODES = 0,
+        PAYLOADS = 1,
+        POSITIONS = 2,
+    };
+    static constexpr std::uint64_t FILES = 3;
+
+    struct Frame
+    {
+        std::unique_ptr<char[]> m_bytes;
+        /**
+         * The page number multiplied by FILES plus the file.
+         */
+        std::uint64_t m_key = NONE;
+        std::uint32_t m_previous = NO_FRAME;
+        std::uint32_t m_next = NO_FRAME;
+        bool m_dirty = false;
+    };
+
+    /**
+     * @return the cached page, read from the file if needed.
+     */
+    char * page(File file, std::uint64_t number, bool write);
+    bool write_back(Frame & frame);
+    void unlink_frame(std::uint32_t frame) noexcept;
+    void push_frame(std::uint32_t frame) noexcept;
+    void drop_frames() noexcept;
+
+    Record read(std::uint64_t node);
+    void write(std::uint64_t node, const Record & record);
+    void read_payload(std::uint64_t offset, std::size_t length, std::string & data);
+    void write_payload(std::uint64_t offset, std::string_view data);
+    std::uint64_t read_position(std::uint64_t node);
+    void write_position(std::uint64_t node, std::uint64_t position);
+
+    std::uint64_t allocate();
+    /**
+     * Appends a node with the given "random" link after the last one.
+     */
+    std::uint64_t append(std::string_view data, std::uint64_t random);
+
+    void fail(int status) noexcept
+    {
+        if (m_status == 0) {
+            m_status = status;
+        }
+    }
+
+    Header m_header;
+    int m_fds[FILES] = {-1, -1, -1};
+    int m_status = 0;
+
+    std::vector<Frame> m_frames;
+    std::size_t m_max_frames = 0;
+    /**
+     * Frames by the keys of the cached pages, at most one per frame.
+     */
+    std::unordered_map<std::uint64_t, std::uint32_t> m_lookup;
+    /**
+     * The most and the least recently used frames.
+     */
+    std::uint32_t m_newest = NO_FRAME;
+    std::uint32_t m_oldest = NO_FRAME;
+};
+
+} // namespace solution
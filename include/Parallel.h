@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace solution {
+
+/**
+ * @param threads requested number of threads, 0 stands for the number of hardware threads.
+ * @return the number of threads to use (at least one).
+ */
+inline std::size_t resolve_threads(std::size_t threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    return std::max<std::size_t>(threads, 1);
+}
+
+/**
+ * Runs task(i) for every i in [0, count) on up to threads threads
+ * (the calling thread is one of them). Tasks are handed out one by one,
+ * so they may take different time. The first exception thrown by a task
+ * is rethrown after all threads are joined.
+ *
+ * @param count number of tasks.
+ * @param threads maximal number of threads.
+ * @param task function that accepts the number of a task.
+ */
+template <typename Task>
+void parallel_for(std::size_t count, std::size_t threads, Task && task)
+{
+    threads = std::min(resolve_threads(threads), count);
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&] {
+        try {
+            for (auto i = next++; i < count; i = next++) {
+                task(i);
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next = count;
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto & thread : workers) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace solution
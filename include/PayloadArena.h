@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Append-only storage for the payloads of list nodes.
+ *
+ * Explanation for implementation.
+ *  - Bytes are copied into large slabs, so short payloads cost neither
+ *    a heap allocation nor the footprint of std::string. Payloads that
+ *    are larger than a quarter of a slab get a slab of their own.
+ *  - Stored bytes are never moved or overwritten, the returned views stay
+ *    valid until release() is called or the arena is destroyed, or while
+ *    the slabs are shared (see share()).
+ *  - Bytes of payloads that are no longer referenced are not reused,
+ *    they are reclaimed all at once by release(). The owner reports
+ *    them to discard(), so it knows when copying the live payloads
+ *    into a fresh arena pays off (see wasteful()).
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class PayloadArena
+{
+public:
+    PayloadArena() = default;
+
+    PayloadArena(const PayloadArena &) = delete;
+    PayloadArena & operator=(const PayloadArena &) = delete;
+
+    PayloadArena(PayloadArena && other) noexcept
+        : m_slabs(std::move(other.m_slabs))
+        , m_cursor(std::exchange(other.m_cursor, nullptr))
+        , m_available(std::exchange(other.m_available, 0))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_garbage(std::exchange(other.m_garbage, 0))
+        , m_discarded(std::exchange(other.m_discarded, 0))
+    {
+        other.m_slabs.clear();
+    }
+
+    PayloadArena & operator=(PayloadArena && other) noexcept
+    {
+        // The cursor of other points into its slabs, so it must not stay behind
+        m_slabs = std::move(other.m_slabs);
+        m_cursor = std::exchange(other.m_cursor, nullptr);
+        m_available = std::exchange(other.m_available, 0);
+        m_size = std::exchange(other.m_size, 0);
+        m_garbage = std::exchange(other.m_garbage, 0);
+        m_discarded = std::exchange(other.m_discarded, 0);
+        other.m_slabs.clear();
+        return *this;
+    }
+
+    /**
+     * Copies data into the arena.
+     * Complexity: O(data.size())
+     *
+     * @param data bytes to store.
+     * @return view of the stored copy.
+     */
+    std::string_view store(std::string_view data);
+
+    /**
+     * Reserves space for data that will be written in place.
+     * Complexity: amortized O(1)
+     *
+     * @param size number of bytes to reserve.
+     * @return pointer to the reserved bytes.
+     */
+    char * allocate(std::size_t size);
+
+    /**
+     * Takes ownership of a buffer that already contains payloads.
+     * Complexity: O(1)
+     *
+     * @param bytes the buffer.
+     * @param size size of the buffer.
+     */
+    void adopt(std::shared_ptr<char[]> bytes, std::size_t size);
+
+    /**
+     * Takes over the slabs of other, views obtained from it stay valid.
+     * Complexity: O(number of slabs)
+     *
+     * @param other arena that becomes empty.
+     */
+    void merge(PayloadArena && other);
+
+    /**
+     * Makes sure that the following payloads of size bytes in total are placed contiguously.
+     * Complexity: O(1)
+     *
+     * @param size total size of the following payloads.
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * Counts the bytes of a payload that is no longer referenced.
+     * Complexity: O(1)
+     *
+     * @param data view obtained from the arena.
+     */
+    void discard(std::string_view data) noexcept
+    {
+        m_garbage += data.size();
+        ++m_discarded;
+    }
+
+    /**
+     * Copying the live payloads costs the number of payloads plus their size,
+     * it pays off once the discarded bytes exceed the live ones and cover the
+     * cost together with the number of discarded payloads.
+     * Complexity: O(1)
+     *
+     * @param payloads the number of live payloads.
+     * @return true if the live payloads should be moved into a fresh arena.
+     */
+    bool wasteful(std::size_t payloads) const noexcept
+    {
+        return m_garbage > m_size / 2 && m_garbage + m_discarded >= payloads;
+    }
+
+    /**
+     * Shares the slabs, views obtained from the arena stay valid while the copies are kept,
+     * even after release() or the destruction of the arena.
+     * Complexity: O(number of slabs)
+     *
+     * @return the slabs.
+     */
+    std::vector<std::shared_ptr<char[]>> share() const { return m_slabs; }
+
+    /**
+     * Frees all slabs at once, all views obtained from the arena become invalid.
+     * Complexity: O(number of slabs)
+     */
+    void release() noexcept;
+
+    /**
+     * Complexity: O(1)
+     * @return the number of bytes stored in the arena.
+     */
+    std::size_t size() const noexcept { return m_size; }
+
+    /**
+     * Complexity: O(1)
+     * @return the number of discarded bytes.
+     */
+    std::size_t garbage() const noexcept { return m_garbage; }
+
+private:
+    std::vector<std::shared_ptr<char[]>> m_slabs;
+    char * m_cursor = nullptr;
+    std::size_t m_available = 0;
+    std::size_t m_size = 0;
+    std::size_t m_garbage = 0;
+    std::size_t m_discarded = 0;
+
+    static constexpr std::size_t SLAB_SIZE = 1 << 16;
+};
+
+} // namespace solution
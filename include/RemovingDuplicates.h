@@ -1,10 +1,210 @@
+#pragma once
+
+#include "Io.h"
+
+#include <cstddef>
+#include <string_view>
+
 namespace solution {
 
+/**
+ * Implementations of remove_duplicates() for the instruction sets of processors.
+ */
+enum class DuplicatesKernel
+{
+    PORTABLE,
+    SSSE3,
+    AVX2,
+    AVX512,
+    NEON
+};
+
 /**
  * Removes consecutively duplicate characters in a string (in place).
  *
+ * Explanation for implementation.
+ *  - The implementation is chosen once at runtime by the features of the
+ *    processor. Vector kernels compare a block of 16, 32 or 64 bytes with
+ *    itself shifted by one byte, the bytes that differ from their
+ *    predecessors are kept and moved together by a shuffle (or a compress
+ *    instruction of AVX-512).
+ *  - Blocks are read from aligned addresses only, so a read never crosses
+ *    the page that holds the terminating null character. The block that
+ *    contains it is processed byte by byte.
+ *
  * @param str pointer to the beginning of a string.
  */
 void remove_duplicates(char * str);
 
+/**
+ * Runs the given implementation of remove_duplicates(), they give the same results.
+ *
+ * @param str pointer to the beginning of a string.
+ * @param kernel the implementation.
+ * @return false if the processor does not support the implementation (str is unchanged).
+ */
+bool remove_duplicates(char * str, DuplicatesKernel kernel);
+
+/**
+ * @return the implementation used by remove_duplicates().
+ */
+DuplicatesKernel remove_duplicates_kernel();
+
+/**
+ * Removes consecutively duplicate characters in a buffer of the given length
+ * (in place), null characters are ordinary ones and no terminator is written.
+ * Complexity: O(length)
+ *
+ * @param data pointer to the beginning of a buffer.
+ * @param length length of the buffer.
+ * @return the new length.
+ */
+std::size_t remove_duplicates(char * data, std::size_t length);
+
+/**
+ * Writes a buffer of the given length without consecutively duplicate
+ * characters to out, as remove_duplicates(data, length) does in place.
+ * Complexity: O(length)
+ *
+ * @param data pointer to the beginning of a buffer.
+ * @param length length of the buffer.
+ * @param out destination of at least length bytes, either data or not overlapping the buffer.
+ * @return the number of bytes written.
+ */
+std::size_t remove_duplicates(const char * data, std::size_t length, char * out);
+
+/**
+ * Runs the given implementation of remove_duplicates() for a buffer.
+ *
+ * @param data pointer to the beginning of a buffer.
+ * @param length length of the buffer, it is replaced with the new length.
+ * @param kernel the implementation.
+ * @return false if the processor does not support the implementation (the buffer is unchanged).
+ */
+bool remove_duplicates(char * data, std::size_t & length, DuplicatesKernel kernel);
+
+/**
+ * Removes consecutively duplicate characters in a buffer of the given length
+ * (in place) on several threads, the result is the same as of remove_duplicates().
+ * Complexity: O(length / threads + new length)
+ *
+ * Explanation for implementation.
+ *  - The buffer is split into chunks of at least a megabyte, a few per thread,
+ *    and every chunk is processed by remove_duplicates() independently.
+ *  - A run of characters that crosses the boundary of chunks is kept in the
+ *    left chunk only: the first character of the right one is dropped if it
+ *    is equal to the last character of the left one before processing.
+ *  - The processed chunks are moved together one by one, as they only move
+ *    to the left. This pass copies the result once more and is not parallel.
+ *
+ * @param data pointer to the beginning of a buffer.
+ * @param length length of the buffer.
+ * @param threads number of threads, 0 stands for the number of hardware threads.
+ * @return the new length.
+ */
+std::size_t remove_duplicates_parallel(char * data, std::size_t length, std::size_t threads = 0);
+
+/**
+ * Removes consecutively duplicate characters in every string of a batch
+ * (in place) on several threads, as remove_duplicates(data, length) does.
+ * Complexity: O(total length / threads + count)
+ *
+ * Explanation for implementation.
+ *  - Consecutive strings are grouped into tasks of tens of kilobytes, so
+ *    that handing out a task is negligible, and the tasks are handed out
+ *    to threads one by one, so long strings do not hold up the others.
+ *  - The strings of a task are handled by the same kernel without any
+ *    dispatch in between, the following strings are prefetched.
+ *
+ * @param strings pointers to the strings.
+ * @param lengths lengths of the strings, they are replaced with the new lengths.
+ * @param count number of strings.
+ * @param threads number of threads, 0 stands for the number of hardware threads.
+ */
+void remove_duplicates_batch(char * const * strings, std::size_t * lengths, std::size_t count, std::size_t threads = 0);
+
+/**
+ * Removes consecutively duplicate characters in every string packed into
+ * a buffer (in place), as remove_duplicates_batch() does. Strings stay at their offsets.
+ * Complexity: O(total length / threads + count)
+ *
+ * @param buffer the strings one after another.
+ * @param offsets count + 1 offsets, the string i is buffer[offsets[i]] ... buffer[offsets[i + 1] - 1].
+ * @param count number of strings.
+ * @param lengths destination of count new lengths.
+ * @param threads number of threads, 0 stands for the number of hardware threads.
+ */
+void remove_duplicates_batch(char * buffer, const std::size_t * offsets, std::size_t count, std::size_t * lengths, std::size_t threads = 0);
+
+/**
+ * Removes consecutively duplicate characters in a stream that comes block by block.
+ *
+ * Explanation for implementation.
+ *  - Every block is processed by remove_duplicates(), the last character
+ *    of the output is kept, so the run that continues the previous block
+ *    is dropped from the output of the next one without copying.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class DuplicatesFilter
+{
+public:
+    /**
+     * Removes duplicates in the next block of the stream.
+     * Complexity: O(length)
+     *
+     * @param data pointer to the block.
+     * @param length length of the block.
+     * @param out destination of at least length bytes, as for remove_duplicates().
+     * @return the output of the block, it points into out.
+     */
+    std::string_view filter(const char * data, std::size_t length, char * out);
+
+    /**
+     * Starts a new stream.
+     */
+    void reset() noexcept { m_started = false; }
+
+private:
+    bool m_started = false;
+    char m_last = '\0';
+};
+
+/**
+ * Writes the bytes of the source without consecutively duplicate characters to the sink.
+ * Blocks of a megabyte are read, so the memory used does not depend on the size of the source.
+ * Complexity: O(n)
+ *
+ * @param source source of the bytes, null characters are ordinary ones.
+ * @param sink destination of the result.
+ * @return 0 if the stream is processed successfully, else - non zero error code.
+ */
+int remove_duplicates(io::Source & source, io::Sink & sink);
+
+/**
+ * Streams the rest of a stdio file to another one as remove_duplicates(source, sink).
+ *
+ * @return 0 if the stream is processed successfully, else - non zero error code.
+ */
+int remove_duplicates(file_ptr_t input, file_ptr_t output);
+
+/**
+ * Streams the rest of the file descriptor to the sink as remove_duplicates(source, sink).
+ * Regular files are mapped to memory window by window instead of being read, so their
+ * bytes are copied once, to the output; pipes and sockets are read by blocks.
+ * Complexity: O(n)
+ *
+ * @param input descriptor of the input, it is left at the end.
+ * @param sink destination of the result.
+ * @return 0 if the stream is processed successfully, else - non zero error code.
+ */
+int remove_duplicates(int input, io::Sink & sink);
+
+/**
+ * Streams the rest of the file descriptor to another one as remove_duplicates(input, sink).
+ *
+ * @return 0 if the stream is processed successfully, else - non zero error code.
+ */
+int remove_duplicates(int input, int output);
+
 } // namespace solution
@@ -1,12 +1,73 @@
+#include "BasicList.h"
+#include "NodePool.h"
+#include "OrderIndex.h"
+#include "PayloadArena.h"
+#include "SerializationFormat.h"
+
+#include <future>
+#include <initializer_list>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace solution {
 
-using file_ptr_t = FILE *;
+/**
+ * Options of List::serialize.
+ */
+struct SerializeOptions
+{
+    /**
+     * Version of the format, the legacy version 1 is readable by old builds.
+     */
+    std::uint16_t version = format::VERSION_2;
+    /**
+     * Appends an offset table that allows ListReader to fetch any element
+     * without decoding the rest of the file (version 2 only).
+     */
+    bool index = false;
+    /**
+     * Writes every distinct payload once and makes records refer to it by number
+     * (version 2 only). Pays off when many payloads repeat: the file shrinks and
+     * the deserialized nodes share the storage of equal payloads.
+     */
+    bool dictionary = false;
+    /**
+     * Compresses every frame on its own (version 2 only), so frames are still
+     * decompressed in parallel and read by ListReader one by one.
+     */
+    bool compress = false;
+    /**
+     * Ends every frame with CRC-32C (version 2 only), so deserialize(), ListReader
+     * and ListStream reject corrupted files. The checksums are computed with the
+     * instructions of the processor where they are available.
+     */
+    bool checksum = true;
+    /**
+     * Number of threads that encode the list (version 2 only), 0 stands for
+     * the number of hardware threads. The output does not depend on it.
+     */
+    std::size_t threads = 1;
+};
+
+/**
+ * Options of List::deserialize.
+ */
+struct DeserializeOptions
+{
+    /**
+     * Number of threads that decode frames of the version 2, 0 stands for
+     * the number of hardware threads.
+     */
+    std::size_t threads = 1;
+};
 
 /**
- * Serializable Doubly Linked List.
+ * Serializable Doubly Linked List of strings, the specialization of BasicList.
  *
  * Explanation for implementation.
  *  - I support the fake node pointed to by tail. This structure
@@ -17,13 +78,74 @@ using file_ptr_t = FILE *;
  *    before the head). In addition, the implementation of the property
  *    is simplified, in which the iterator to the end of the list is
  *    easy to decrement and always get the last element.
+ *  - Nodes are allocated from a slab pool owned by the list, so
+ *    neighbouring nodes usually share cache lines and pages, and
+ *    clear() returns whole slabs instead of freeing nodes one by one.
+ *  - Payloads are stored in an arena owned by the list and nodes only
+ *    keep views of them. Iterators expose payloads as std::string_view,
+ *    use assign() to replace the payload of an element. Bytes of erased
+ *    and replaced payloads are counted, once they outweigh the live ones
+ *    the live payloads are copied into a fresh arena, so the memory stays
+ *    proportional to the list under any churn.
+ *  - After snapshot() or restore() the changes are recorded in an
+ *    encoded form, so checkpoint() appends them to a journal in time
+ *    proportional to their number. Nodes are identified by numbers
+ *    kept in an array indexed by pool slots, which costs nothing
+ *    while the changes are not tracked.
+ *  - freeze() moves read-mostly lists into arrays, then iterators
+ *    work with indexes instead of pointers and traversals are linear
+ *    scans of memory. The first change thaws the list.
+ *  - Iterators keep the list as well as the node: the end, the "random"
+ *    order and the frozen form are reached through it. So unlike
+ *    std::list, moving or splicing a list invalidates the iterators to
+ *    its elements, the moved elements are reached through the new list.
+ *  - serialize_async() takes a snapshot: the views of the payloads and
+ *    the order of the list are copied, while the payloads themselves are
+ *    shared with the arena, which never moves or overwrites stored bytes
+ *    and keeps its slabs alive while they are shared. The snapshot is
+ *    encoded by a thread of its own, so the owner keeps changing the
+ *    list without any synchronization.
  *
  * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
  */
-class List
+template <>
+class BasicList<std::string>
 {
 public:
-    List();
+    BasicList();
+    ~BasicList();
+
+    BasicList(const BasicList &) = delete;
+    BasicList & operator=(const BasicList &) = delete;
+
+    /**
+     * Takes the nodes, payloads, index and journal of other, which becomes empty.
+     * Iterators to the elements of other become invalid.
+     * Complexity: O(1)
+     */
+    BasicList(BasicList && other) noexcept;
+    /**
+     * Replaces the elements with the elements of other, which becomes empty.
+     * Iterators to the elements of both lists become invalid.
+     * Complexity: O(number of slabs of this list)
+     */
+    BasicList & operator=(BasicList && other) noexcept;
+
+    /**
+     * Constructs the list from the range of values convertible to std::string_view.
+     * Complexity: O(n + total size of payloads)
+     */
+    template <typename InputIt>
+    BasicList(InputIt first, InputIt last)
+        : BasicList()
+    {
+        insert(end(), first, last);
+    }
+
+    BasicList(std::initializer_list<std::string_view> values)
+        : BasicList(values.begin(), values.end())
+    {
+    }
 
 private:
     struct ListNode
@@ -31,7 +153,7 @@ private:
         ListNode * m_previous = nullptr;
         ListNode * m_next = nullptr;
         ListNode * m_random = nullptr;
-        std::string m_data;
+        std::string_view m_data;
     };
 
 public:
@@ -41,31 +163,34 @@ public:
     template <typename T>
     struct IteratorT
     {
-        friend class List;
+        friend class BasicList;
 
         using difference_type = std::ptrdiff_t;
         using iterator_category = std::bidirectional_iterator_tag;
-        using value_type = T;
-        using reference = T &;
-        using pointer = T *;
+        using value_type = std::remove_const_t<T>;
+        using reference = const value_type &;
+        using pointer = const value_type *;
 
         /**
          * Constructor that allows you to cast a non-const iterator to a const iterator.
          */
         template <typename U, typename = std::enable_if_t<std::is_const_v<T> && !std::is_const_v<U>>>
         IteratorT(const IteratorT<U> & iterator)
-            : m_pointer(iterator.m_pointer)
+            : m_list(iterator.m_list)
+            , m_pointer(iterator.m_pointer)
+            , m_index(iterator.m_index)
+            , m_view(iterator.m_view)
         {
         }
 
         pointer operator->() const
         {
-            return &m_pointer->m_data;
+            return m_pointer ? &m_pointer->m_data : m_view;
         }
 
         reference operator*() const
         {
-            return m_pointer->m_data;
+            return m_pointer ? m_pointer->m_data : *m_view;
         }
 
     private:
@@ -78,7 +203,7 @@ public:
         {
             auto * next = current->m_random;
             if (!next) {
-                return m_tail;
+                return &m_list->m_tail;
             }
             return next;
         }
@@ -91,7 +216,13 @@ public:
          */
         IteratorT & move()
         {
-            m_pointer = next(m_pointer);
+            if (m_pointer) {
+                m_pointer = next(m_pointer);
+            }
+            else {
+                const auto & randoms = m_list->m_frozen->m_randoms;
+                seek(m_index < randoms.size() ? randoms[m_index] : m_index);
+            }
             return *this;
         }
 
@@ -100,7 +231,8 @@ public:
          */
         IteratorT next()
         {
-            return IteratorT{m_tail, next(m_pointer)};
+            auto result = *this;
+            return result.move();
         }
 
         /**
@@ -108,12 +240,17 @@ public:
          */
         void link(const IteratorT & random)
         {
-            m_pointer->m_random = random.m_pointer;
+            m_list->link(*this, random);
         }
 
         IteratorT & operator++()
         {
-            m_pointer = m_pointer->m_next;
+            if (m_pointer) {
+                m_pointer = m_pointer->m_next;
+            }
+            else {
+                seek(m_index + 1);
+            }
             return *this;
         }
 
@@ -126,7 +263,12 @@ public:
 
         IteratorT & operator--()
         {
-            m_pointer = m_pointer->m_previous;
+            if (m_pointer) {
+                m_pointer = m_pointer->m_previous;
+            }
+            else {
+                seek(m_index - 1);
+            }
             return *this;
         }
 
@@ -139,7 +281,7 @@ public:
 
         friend bool operator==(const IteratorT & lhs, const IteratorT & rhs)
         {
-            return lhs.m_pointer == rhs.m_pointer;
+            return lhs.m_pointer == rhs.m_pointer && lhs.m_index == rhs.m_index;
         }
 
         friend bool operator!=(const IteratorT & lhs, const IteratorT & rhs)
@@ -148,19 +290,41 @@ public:
         }
 
     private:
-        ListNode * m_tail;
+        BasicList * m_list;
+        /**
+         * Null for the iterators of a frozen list, which use m_index.
+         */
         ListNode * m_pointer;
+        std::size_t m_index = 0;
+        /**
+         * The payload of the element m_index of a frozen list, kept by the list
+         * until it is thawed.
+         */
+        const std::string_view * m_view = nullptr;
 
-        explicit IteratorT(ListNode * tail, ListNode * pointer)
-            : m_tail(tail)
+        explicit IteratorT(BasicList * list, ListNode * pointer)
+            : m_list(list)
             , m_pointer(pointer)
         {
         }
+
+        explicit IteratorT(BasicList * list, std::size_t index)
+            : m_list(list)
+            , m_pointer(nullptr)
+        {
+            seek(index);
+        }
+
+        void seek(std::size_t index) noexcept
+        {
+            m_index = index;
+            m_view = &m_list->m_frozen->at(index);
+        }
     };
 
 public:
-    using Iterator = IteratorT<std::string>;
-    using ConstIterator = IteratorT<const std::string>;
+    using Iterator = IteratorT<std::string_view>;
+    using ConstIterator = IteratorT<const std::string_view>;
 
     /**
      * Complexity: O(1)
@@ -183,6 +347,52 @@ public:
      */
     Iterator insert(ConstIterator position, std::string_view data);
 
+    /**
+     * Inserts the range of values convertible to std::string_view before position.
+     * Nodes and payloads of a range of forward iterators are allocated at once and
+     * lie next to each other.
+     * Complexity: O(distance + total size of payloads), O(distance log n) if the list is indexed
+     *
+     * @return iterator to the first inserted element, position if the range is empty.
+     */
+    template <typename InputIt>
+    Iterator insert(ConstIterator position, InputIt first, InputIt last)
+    {
+        auto * next = resolve(position);
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            std::size_t count = 0;
+            std::size_t bytes = 0;
+            for (auto it = first; it != last; ++it, ++count) {
+                bytes += std::string_view(*it).size();
+            }
+            m_pool.reserve(count);
+            m_arena.reserve(bytes);
+        }
+        Iterator result{this, next};
+        for (bool inserted = false; first != last; ++first) {
+            auto it = insert(ConstIterator{this, next}, std::string_view(*first));
+            if (!inserted) {
+                result = it;
+                inserted = true;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Moves all elements of other before position, other becomes empty.
+     * Nodes and payloads stay where they are: this list takes over the
+     * memory of other. "Random" links keep pointing to the same elements,
+     * iterators to the elements of other become invalid.
+     * Complexity: O(number of slabs of other), plus O(n) if this list is indexed.
+     * If any of the lists records changes (see snapshot()), the elements are
+     * copied one by one and recorded: O(size of other).
+     *
+     * @param position iterator before which the elements will be inserted.
+     * @param other list whose elements are moved.
+     */
+    void splice(ConstIterator position, BasicList & other);
+
     /**
      * Prepends the given data to the beginning of the list.
      *
@@ -200,13 +410,34 @@ public:
     Iterator push_back(std::string_view data);
 
     /**
-     * Complexity: O(1)
-     * Removes the data at position.
+     * Replaces the data at position.
+     * Complexity: amortized O(data.size() + size of the previous data)
+     *
+     * Bytes of the previous data are reclaimed once the discarded bytes
+     * outweigh the live ones: the payloads are moved then, and views of
+     * them obtained before the call become invalid (iterators stay valid).
+     *
+     * @param position iterator to the element to update.
+     * @param data new data.
+     * @return iterator to the updated element.
+     */
+    Iterator assign(ConstIterator position, std::string_view data);
+
+    /**
+     * Complexity: amortized O(1 + size of the data)
+     * Removes the data at position, its bytes are reclaimed as by assign().
      *
      * @param position iterator to the element to remove.
      * @return iterator following the removed element.
      */
     Iterator erase(ConstIterator position);
+    /**
+     * Removes the elements in [first, last).
+     * Complexity: O(log n + distance) if the list is indexed, else - O(distance)
+     *
+     * @return iterator following the removed elements.
+     */
+    Iterator erase(ConstIterator first, ConstIterator last);
 
     /**
      * Removes the data at the beginning of the list.
@@ -224,11 +455,127 @@ public:
     Iterator pop_back();
 
     /**
-     * Erases all elements from the list.
-     * Complexity: O(n)
+     * Erases all elements from the list and releases the memory of the nodes and payloads.
+     * Complexity: O(number of slabs)
      */
     void clear();
 
+    /**
+     * Moves the elements into the frozen form: payloads lie one after another
+     * in a single block, views of them and 32-bit indexes of the "random"
+     * elements are kept in arrays. Iteration and serialization of a frozen
+     * list scan these arrays in order. Iterators become invalid, references
+     * returned by the new ones stay valid until the list is thawed.
+     * Complexity: O(n log(number of slabs) + total size of payloads)
+     *
+     * @return false if changes are recorded (see snapshot()) or the list has 2^32 - 1 elements or more.
+     */
+    bool freeze();
+    /**
+     * Moves the elements of a frozen list back into nodes. Any change of
+     * a frozen list does this first, the iterators passed to it stay valid
+     * for the change while the other ones become invalid.
+     * Complexity: O(n)
+     */
+    void thaw();
+    /**
+     * Complexity: O(1)
+     * @return true if the list is frozen.
+     */
+    bool frozen() const noexcept { return m_frozen != nullptr; }
+
+    /**
+     * Starts keeping an order-statistic tree over the nodes, which makes
+     * at() and index_of() logarithmic at the cost of O(log n) per insert
+     * and erase and 20 bytes per node.
+     * Complexity: O(n log(number of slabs))
+     *
+     * @return false if the list has 2^32 - 1 elements or more.
+     */
+    bool enable_index();
+    void disable_index() noexcept { m_index.reset(); }
+    /**
+     * Complexity: O(1)
+     * @return true if the list is indexed.
+     */
+    bool indexed() const noexcept { return m_index != nullptr; }
+
+    /**
+     * Complexity: O(1) if the list is frozen, O(log n) if it is indexed, else - O(position)
+     * @return iterator to the element at position or end().
+     */
+    Iterator at(std::size_t position);
+    ConstIterator at(std::size_t position) const;
+    /**
+     * Complexity: O(1) if the list is frozen, O(log n) if it is indexed, else - O(n)
+     * @return the number of elements before the given one.
+     */
+    std::size_t index_of(ConstIterator position) const;
+
+    /**
+     * The order of the nodes in memory after compact().
+     */
+    enum class Order
+    {
+        /**
+         * The order of the list.
+         */
+        SEQUENTIAL,
+        /**
+         * The order of "random" links: chains of links one after another,
+         * each one starts at the first element that is not placed yet.
+         */
+        RANDOM,
+    };
+
+    /**
+     * Moves the nodes and the payloads into single blocks in the given order,
+     * so traversals in this order read memory sequentially. Iterators become
+     * invalid, recorded changes are kept. Frozen lists are left as they are.
+     * Complexity: O(n log(number of slabs) + total size of payloads)
+     *
+     * @param order the order of the nodes in memory.
+     */
+    void compact(Order order = Order::SEQUENTIAL);
+
+    /**
+     * Calls visitor(data) for elements in "random" order starting at first,
+     * stops at the end or after count elements. The nodes and the payloads
+     * a few links ahead are prefetched while the current one is visited.
+     * Complexity: O(count)
+     *
+     * @param distance the number of links between the visited node and the prefetched one.
+     */
+    template <typename Visitor>
+    void for_each_random(ConstIterator first, std::size_t count, Visitor && visitor, std::size_t distance = PREFETCH_DISTANCE) const
+    {
+        if (m_frozen) {
+            for (; count != 0 && first != end(); --count, first.move()) {
+                visitor(*first);
+            }
+            return;
+        }
+        const auto hop = [this](const ListNode * node) -> const ListNode * {
+            return node->m_random ? node->m_random : &m_tail;
+        };
+        const ListNode * current = first.m_pointer;
+        const ListNode * ahead = current;
+        for (std::size_t i = 0; i < distance && ahead != &m_tail; ++i) {
+            prefetch(ahead->m_data.data());
+            ahead = hop(ahead);
+            prefetch(ahead);
+        }
+        for (; count != 0 && current != &m_tail; --count) {
+            if (ahead != &m_tail) {
+                prefetch(ahead->m_data.data());
+                ahead = hop(ahead);
+                prefetch(ahead);
+            }
+            visitor(current->m_data);
+            current = hop(current);
+        }
+    }
+
     /**
      * Complexity: O(1)
      * @return an iterator to the beginning.
@@ -253,26 +600,252 @@ public:
 
 public:
     /**
-     * Serializes a list and writes the result to a binary file.
+     * Serializes a list and writes the result to a binary file. Payloads larger than
+     * format::MAX_PAYLOAD_SIZE are written by the version 2 only with the dictionary,
+     * otherwise the error code 2 is returned.
      * Complexity: O(n)
      *
      * @param file the file to which the list should be serialized.
+     * @param options format options.
+     * @return 0 if list serialized successfully, else - non zero error code.
+     */
+    int serialize(file_ptr_t file, const SerializeOptions & options = {});
+    /**
+     * Serializes a list and writes the result to a sink.
+     * Complexity: O(n)
+     *
+     * @param sink the sink to which the list should be serialized.
+     * @param options format options.
      * @return 0 if list serialized successfully, else - non zero error code.
      */
-    int serialize(file_ptr_t file);
+    int serialize(io::Sink & sink, const SerializeOptions & options = {});
+    /**
+     * Serializes the list in the background. The result reflects the list at
+     * the moment of the call, which may be changed right after it returns.
+     * The file must not be used by any thread until the result is ready.
+     * Lists of std::uint32_t maximum elements or more are not supported,
+     * the error code 2 is returned for them.
+     * Complexity: O(n log(number of slabs)) for the caller, O(n) in the background
+     *
+     * @param file the file to which the list should be serialized.
+     * @param options format options.
+     * @return the future result of serialize(), its destructor waits for the completion.
+     */
+    std::future<int> serialize_async(file_ptr_t file, const SerializeOptions & options = {});
     /**
      * Deserializes the list according to the data from the binary file.
+     * Both versions of the format are accepted, the list is left unchanged on failure.
      * Complexity: O(n)
      *
      * @param file the file from which the list should be deserialized.
+     * @param options decoding options.
+     * @return 0 if list deserialized successfully, else - non zero error code.
+     */
+    int deserialize(file_ptr_t file, const DeserializeOptions & options = {});
+    /**
+     * Deserializes the list according to the data from a source.
+     * Complexity: O(n)
+     *
+     * @param source the source from which the list should be deserialized.
+     * @param options decoding options.
      * @return 0 if list deserialized successfully, else - non zero error code.
      */
-    int deserialize(file_ptr_t file);
+    int deserialize(io::Source & source, const DeserializeOptions & options = {});
+
+    /**
+     * Serializes the list and makes the result the base of a journal: the following
+     * changes are recorded until the next call of snapshot() or deserialize().
+     * Taking a snapshot of a restored list compacts its journal.
+     * Complexity: O(n)
+     *
+     * @param file the file to which the snapshot should be written.
+     * @param options format options.
+     * @return 0 if the snapshot is written successfully, else - non zero error code.
+     */
+    int snapshot(file_ptr_t file, const SerializeOptions & options = {});
+    /**
+     * Appends the changes made since the last snapshot() or checkpoint() to the journal.
+     * The changes are kept if writing fails, the journal should be replaced by a new snapshot then.
+     * Complexity: O(size of the changes)
+     *
+     * @param journal the file opened for appending.
+     * @return 0 if the changes are written successfully, else - non zero error code.
+     */
+    int checkpoint(file_ptr_t journal);
+    /**
+     * Deserializes a snapshot and replays the journal written on top of it.
+     * The following changes are recorded, so checkpoint() may keep appending
+     * to the same journal. A truncated segment at the end of the journal
+     * (left by an interrupted checkpoint()) is ignored, the list is left
+     * unchanged on other failures.
+     * Complexity: O(n + size of the journal)
+     *
+     * @param snapshot the file written by snapshot().
+     * @param journal the file written by checkpoint().
+     * @param options decoding options.
+     * @return 0 if list restored successfully, else - non zero error code.
+     */
+    int restore(file_ptr_t snapshot, file_ptr_t journal, const DeserializeOptions & options = {});
 
 private:
+    /**
+     * Changes made since the last checkpoint.
+     */
+    struct Journal
+    {
+        /**
+         * Identifiers of the nodes by the numbers of their slots in the pool.
+         */
+        std::vector<std::uint64_t> m_ids;
+        std::uint64_t m_next_id = 0;
+        std::vector<char> m_changes;
+        std::uint64_t m_count = 0;
+    };
+
+    /**
+     * Contiguous form of the list made by freeze(), also a snapshot of the list made by snapshot().
+     */
+    struct Frozen
+    {
+        /**
+         * Blocks that hold the payloads, freeze() copies them one after another into a single block.
+         */
+        std::vector<std::shared_ptr<char[]>> m_blocks;
+        /**
+         * Payloads in m_blocks and an empty view for the end, iterators refer to them.
+         */
+        std::vector<std::string_view> m_views;
+        /**
+         * The total size of the payloads.
+         */
+        std::uint64_t m_size = 0;
+        /**
+         * Indexes of the "random" elements, the size of the list if there is no such element.
+         */
+        std::vector<std::uint32_t> m_randoms;
+
+        /**
+         * @return the payload of the element, empty for the end.
+         */
+        const std::string_view & at(std::size_t index) const noexcept
+        {
+            return m_views[std::min(index, m_views.size() - 1)];
+        }
+    };
+
+    /**
+     * Updates "random" order of the element.
+     */
+    void link(const ConstIterator & position, const ConstIterator & random);
+
+    /**
+     * Thaws a frozen list.
+     *
+     * @return the node at position.
+     */
+    ListNode * resolve(const ConstIterator & position);
+
+    /**
+     * Starts recording changes.
+     *
+     * @param nodes the nodes by their identifiers, erased ones are null.
+     */
+    void track(const std::vector<ListNode *> & nodes);
+    /**
+     * Appends a change to the journal, the changes must be recorded.
+     *
+     * @param fields the identifiers (or encoded identifiers) of the change.
+     * @param data payload of the change.
+     */
+    void record(format::Change kind, std::initializer_list<std::uint64_t> fields, std::string_view data = {});
+    std::uint64_t id(const ListNode * node) const noexcept;
+    /**
+     * Assigns the next identifier to the inserted node.
+     */
+    void identify(const ListNode * node);
+
+    /**
+     * Applies the journal to the list. Must be called before track().
+     *
+     * @param available the size of the journal or format::UNKNOWN_SIZE.
+     * @param nodes the nodes by their identifiers, updated by the changes.
+     */
+    int replay(format::Reader & reader, std::uint64_t available, std::vector<ListNode *> & nodes);
+    /**
+     * Replaces the elements of the list with the elements of other, which becomes empty.
+     */
+    void take(BasicList & other);
+
+    /**
+     * Links a new node with already stored data before position.
+     */
+    ListNode * link_before(ListNode * position, std::string_view stored);
+    /**
+     * Removes the node from the chain, but not from the index.
+     *
+     * @return the following node.
+     */
+    ListNode * unlink(ListNode * node);
+    /**
+     * Counts the bytes of a payload that is no longer referenced and moves
+     * the live payloads into a fresh arena once the arena is wasteful.
+     */
+    void discard(std::string_view data);
+    /**
+     * Rebuilds the index of an indexed list from the chain of nodes.
+     */
+    void reindex();
+
+    /**
+     * Copies the views of the payloads and the order of the list, the payloads are shared.
+     * The size of the list must be less than the maximum of std::uint32_t.
+     * Complexity: O(n log(number of slabs))
+     */
+    std::unique_ptr<Frozen> snapshot() const;
+    /**
+     * Encodes the elements given by their payloads and by the indexes of the
+     * "random" elements plus one, zero if there is no such element.
+     */
+    template <class Payload, class Random>
+    static int encode(io::Sink & sink, const SerializeOptions & options, std::size_t count, std::uint64_t payload_size, const Payload & payload, const Random & random);
+    /**
+     * Serializes a frozen list or a snapshot, the list itself is not read.
+     */
+    static int serialize(io::Sink & sink, const SerializeOptions & options, const Frozen & frozen);
+
+    int deserialize_v1(format::Reader & reader);
+    /**
+     * Nodes are placed into a single block, frames are decoded in parallel
+     * and become the storage of the payloads.
+     */
+    int deserialize_v2(format::Reader & reader, std::uint64_t available, const DeserializeOptions & options);
+
+    NodePool<ListNode> m_pool;
+    PayloadArena m_arena;
     mutable ListNode m_tail;
     ListNode * m_head;
     std::size_t m_size;
+    std::unique_ptr<Journal> m_journal;
+    /**
+     * Not null while the list is frozen, then it has no nodes.
+     */
+    std::unique_ptr<Frozen> m_frozen;
+    /**
+     * Positions of the nodes by the numbers of their slots in the pool, null if the list is not indexed.
+     */
+    std::unique_ptr<OrderIndex> m_index;
+
+    static void prefetch([[maybe_unused]] const void * address) noexcept
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(address);
+#endif
+    }
+
+    /**
+     * The default distance of prefetching in for_each_random().
+     */
+    static constexpr std::size_t PREFETCH_DISTANCE = 8;
 
     /**
      * Special value for encoding null pointer in serialization.
@@ -280,4 +853,6 @@ private:
     static constexpr auto NO_RANDOM = std::numeric_limits<std::size_t>::max();
 };
 
+using List = BasicList<std::string>;
+
 } // namespace solution
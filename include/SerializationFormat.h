@@ -0,0 +1,522 @@
+#pragma once
+
+#include "Io.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace solution {
+
+/**
+ * Building blocks of the binary format of serialized lists.
+ *
+ * Version 1 (legacy): a sequence of records, each record is the payload
+ * terminated by '\0' followed by the native std::size_t index of the
+ * "random" node (NO_RANDOM if there is no such node).
+ *
+ * Version 2, all integers are little-endian:
+ *  - header: magic "\x89LST", u16 version, u16 flags, u64 number of nodes,
+ *    u64 total size of payloads;
+ *  - dictionary (if FLAG_DICTIONARY is set): u64 number of entries, u64
+ *    size of the body and the body, every entry is a varint length and
+ *    the payload bytes, followed by u32 CRC-32C of them if FLAG_CHECKSUM
+ *    is set;
+ *  - frames until all nodes are read: u32 number of records, u32 size of
+ *    the body in bytes and the body itself. Records never cross frame
+ *    boundaries, each record is a varint length, the payload bytes and
+ *    a varint index of the "random" node plus one (zero if there is no
+ *    such node). If FLAG_DICTIONARY is set, the length and the payload
+ *    bytes are replaced with the varint number of a dictionary entry.
+ *    If FLAG_COMPRESSED is set, the body is u32 size of the records
+ *    followed by the records compressed as a block of lz (or stored as
+ *    they are if the compression does not make them smaller). If
+ *    FLAG_CHECKSUM is set, the body (compressed one if FLAG_COMPRESSED is
+ *    set) ends with u32 CRC-32C of the preceding bytes of the body;
+ *  - index (if FLAG_INDEX is set): u64 number of frames, u64 offset and
+ *    u64 index of the first record for each frame, u32 offset of each
+ *    record in the body of its frame;
+ *  - footer (if FLAG_INDEX is set): u64 offset of the index and magic.
+ *
+ * Offsets are counted from the first byte of the header, offsets of the
+ * records are counted in the decompressed bodies.
+ *
+ * Journal of changes made on top of a snapshot: segments appended one after
+ * another, each segment is magic "\x89LSJ", u64 number of changes, u64 size
+ * of the body and the body. Every change is its Change kind (one byte) and
+ * varint fields that refer to nodes by identifiers: nodes of the snapshot
+ * are numbered by their positions, inserted nodes get the following numbers
+ * in the order of insertion.
+ *  - INSERT: identifier of the next node plus one (zero for the end),
+ *    varint length and the payload;
+ *  - ERASE: identifier of the node;
+ *  - LINK: identifier of the node, identifier of the "random" node plus
+ *    one (zero if there is no such node);
+ *  - ASSIGN: identifier of the node, varint length and the payload;
+ *  - CLEAR: no fields.
+ */
+namespace format {
+
+constexpr std::string_view MAGIC{"\x89LST", 4};
+
+constexpr std::uint16_t VERSION_1 = 1;
+constexpr std::uint16_t VERSION_2 = 2;
+
+constexpr std::uint16_t FLAG_INDEX = 1;
+constexpr std::uint16_t FLAG_DICTIONARY = 2;
+constexpr std::uint16_t FLAG_COMPRESSED = 4;
+constexpr std::uint16_t FLAG_CHECKSUM = 8;
+constexpr std::uint16_t KNOWN_FLAGS = FLAG_INDEX | FLAG_DICTIONARY | FLAG_COMPRESSED | FLAG_CHECKSUM;
+
+constexpr std::size_t HEADER_SIZE = 24;
+constexpr std::size_t FRAME_HEADER_SIZE = 8;
+constexpr std::size_t FRAME_ENTRY_SIZE = 16;
+constexpr std::size_t FOOTER_SIZE = 12;
+constexpr std::size_t DICTIONARY_HEADER_SIZE = 16;
+constexpr std::size_t CHECKSUM_SIZE = 4;
+
+constexpr std::string_view JOURNAL_MAGIC{"\x89LSJ", 4};
+constexpr std::size_t SEGMENT_HEADER_SIZE = 20;
+
+/**
+ * Kinds of changes in the journal.
+ */
+enum class Change : char
+{
+    INSERT = 1,
+    ERASE,
+    LINK,
+    ASSIGN,
+    CLEAR
+};
+
+/**
+ * Frames are flushed once their bodies reach this size.
+ */
+constexpr std::size_t FRAME_SIZE = 1 << 16;
+
+/**
+ * Frames keep their sizes and the offsets of records in 32 bits, so larger
+ * payloads are written to the dictionary or in the version 1 only.
+ */
+constexpr std::uint64_t MAX_PAYLOAD_SIZE = std::uint64_t{3} << 30;
+
+/**
+ * The maximal size of an encoded varint.
+ */
+constexpr std::size_t MAX_VARINT_SIZE = 10;
+
+inline void put_u16(char * out, std::uint16_t value)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        out[i] = static_cast<char>(value >> (i << 3));
+    }
+}
+
+inline void put_u32(char * out, std::uint32_t value)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        out[i] = static_cast<char>(value >> (i << 3));
+    }
+}
+
+inline void put_u64(char * out, std::uint64_t value)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        out[i] = static_cast<char>(value >> (i << 3));
+    }
+}
+
+template <typename IntegerT>
+IntegerT get_integer(const char * in)
+{
+    IntegerT value = 0;
+    for (std::size_t i = 0; i < sizeof(IntegerT); ++i) {
+        value |= static_cast<IntegerT>(static_cast<unsigned char>(in[i])) << (i << 3);
+    }
+    return value;
+}
+
+/**
+ * Encodes value as LEB128.
+ *
+ * @param out buffer with at least MAX_VARINT_SIZE free bytes.
+ * @return pointer past the last written byte.
+ */
+inline char * put_varint(char * out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        *(out++) = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *(out++) = static_cast<char>(value);
+    return out;
+}
+
+/**
+ * Decodes LEB128 value.
+ *
+ * @param in pointer to the encoded value, moved past it on success.
+ * @param end end of the available data.
+ * @param value decoded value.
+ * @return false if the value is truncated or malformed.
+ */
+inline bool get_varint(const char *& in, const char * end, std::uint64_t & value)
+{
+    value = 0;
+    for (unsigned shift = 0; in != end && shift < 64; shift += 7) {
+        const auto byte = static_cast<unsigned char>(*(in++));
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * The size of a source that is not seekable.
+ */
+constexpr std::uint64_t UNKNOWN_SIZE = io::UNKNOWN_SIZE;
+
+/**
+ * Header of the version 2.
+ */
+struct Header
+{
+    std::uint16_t m_version = VERSION_2;
+    std::uint16_t m_flags = 0;
+    std::uint64_t m_count = 0;
+    std::uint64_t m_payload_size = 0;
+
+    /**
+     * @param out buffer of HEADER_SIZE bytes.
+     */
+    void encode(char * out) const;
+
+    /**
+     * @param in buffer of HEADER_SIZE bytes.
+     * @return false if it is not a header of the version 2 or some flags are unknown.
+     */
+    bool decode(const char * in);
+};
+
+/**
+ * Distinct payloads, records of a list written with FLAG_DICTIONARY refer to them by numbers.
+ */
+using Dictionary = std::vector<std::string_view>;
+
+/**
+ * Entry of the frame table of the index.
+ */
+struct FrameEntry
+{
+    std::uint64_t m_offset;
+    std::uint64_t m_first;
+};
+
+/**
+ * Buffered writer to a sink: small writes are gathered in a block,
+ * large ones go straight to the sink.
+ */
+class Writer
+{
+public:
+    explicit Writer(io::Sink & sink);
+
+    void write(const char * data, std::size_t size);
+    void write(std::string_view data) { write(data.data(), data.size()); }
+
+    /**
+     * Writes the buffered data to the sink and flushes it.
+     *
+     * @return false if some write has failed.
+     */
+    bool flush();
+
+    /**
+     * @return the number of bytes written since construction (including buffered ones).
+     */
+    std::uint64_t offset() const noexcept { return m_offset; }
+
+private:
+    io::Sink & m_sink;
+    std::vector<char> m_buffer;
+    std::uint64_t m_offset = 0;
+    bool m_good = true;
+};
+
+/**
+ * Buffered reader from a source that reads data in large blocks.
+ * On destruction the bytes that were read ahead but not consumed
+ * are returned to the source.
+ */
+class Reader
+{
+public:
+    explicit Reader(io::Source & source);
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader & operator=(const Reader &) = delete;
+
+    /**
+     * @return the next byte or EOF.
+     */
+    int get()
+    {
+        if (m_position == m_size && !fill()) {
+            return EOF;
+        }
+        return static_cast<unsigned char>(m_buffer[m_position++]);
+    }
+
+    /**
+     * Reads exactly size bytes.
+     *
+     * @return false if the file has ended earlier.
+     */
+    bool read(char * data, std::size_t size);
+
+    /**
+     * Looks at the next bytes without consuming them.
+     *
+     * @return view of at most size next bytes (less only at the end of the file).
+     */
+    std::string_view peek(std::size_t size);
+
+    /**
+     * Consumes the bytes up to the next occurrence of delimiter and the delimiter itself.
+     *
+     * @param out string to which the bytes are appended (without delimiter).
+     * @return false if the file has ended before the delimiter.
+     */
+    bool read_until(char delimiter, std::string & out);
+
+private:
+    bool fill();
+
+    io::Source & m_source;
+    std::vector<char> m_buffer;
+    std::size_t m_position = 0;
+    std::size_t m_size = 0;
+};
+
+/**
+ * Encodes records into frames of the version 2 at the end of a buffer.
+ */
+class FrameEncoder
+{
+public:
+    /**
+     * @param out buffer to which the frames are appended.
+     * @param checksum whether the bodies end with checksums.
+     */
+    explicit FrameEncoder(std::vector<char> & out, bool checksum = false);
+
+    /**
+     * Appends a record to the current frame.
+     *
+     * @param data payload of the node.
+     * @param random index of the "random" node plus one, zero if there is no such node.
+     * @return offset of the record in the body of the frame.
+     */
+    std::uint32_t add(std::string_view data, std::uint64_t random);
+    /**
+     * Appends a record that refers to a dictionary entry to the current frame.
+     *
+     * @param entry the number of the dictionary entry.
+     * @param random index of the "random" node plus one, zero if there is no such node.
+     * @return offset of the record in the body of the frame.
+     */
+    std::uint32_t add_reference(std::uint64_t entry, std::uint64_t random);
+
+    bool empty() const noexcept { return m_records == 0; }
+    bool full() const noexcept { return !empty() && m_out.size() - m_frame - FRAME_HEADER_SIZE >= FRAME_SIZE; }
+
+    /**
+     * Completes the current (not empty) frame, the next record starts a new one.
+     *
+     * @return offset of the completed frame in the buffer.
+     */
+    std::size_t flush();
+
+private:
+    std::vector<char> & m_out;
+    bool m_checksum;
+    std::size_t m_frame = 0;
+    std::uint32_t m_records = 0;
+};
+
+/**
+ * Writes the index and the footer.
+ *
+ * @param writer writer positioned after the last frame.
+ * @param frames frame table.
+ * @param records offsets of the records in their frames.
+ */
+void write_index(Writer & writer, const std::vector<FrameEntry> & frames, const std::vector<std::uint32_t> & records);
+
+/**
+ * Compresses the frames encoded by FrameEncoder.
+ *
+ * @param in the frames.
+ * @param frames the frame table of in, the offsets are replaced with the offsets in out.
+ * @param out buffer to which the compressed frames are appended.
+ * @param checksum whether the compressed bodies end with checksums.
+ */
+void compress_frames(const std::vector<char> & in, std::vector<FrameEntry> & frames, std::vector<char> & out, bool checksum);
+
+/**
+ * @param body the body of a compressed frame.
+ * @return the size of the decompressed body or UNKNOWN_SIZE if the body is malformed.
+ */
+std::uint64_t decompressed_size(std::string_view body);
+
+/**
+ * Decompresses the body of a frame.
+ *
+ * @param body the body of a compressed frame.
+ * @param out buffer of decompressed_size(body) bytes.
+ * @return false if the body is malformed.
+ */
+bool decompress_frame(std::string_view body, char * out);
+
+/**
+ * Appends the checksum of the bytes of the buffer.
+ *
+ * @param first the first byte covered by the checksum.
+ */
+void append_checksum(std::vector<char> & out, std::size_t first);
+
+/**
+ * Checks the checksum at the end of a body.
+ *
+ * @param body the body, the checksum is removed from it on success.
+ * @return false if the checksum does not match.
+ */
+bool verify_checksum(std::string_view & body);
+
+/**
+ * Checks the checksum and decompresses the body of a frame according to the flags of the header.
+ *
+ * @param body the stored body, replaced with the records on success.
+ * @param buffer buffer that may be swapped with the body.
+ * @return false if the body is malformed.
+ */
+bool unpack_frame(std::uint16_t flags, std::vector<char> & body, std::vector<char> & buffer);
+
+/**
+ * Writes the dictionary section.
+ *
+ * @param writer writer positioned after the header.
+ * @param checksum whether the body ends with a checksum.
+ */
+void write_dictionary(Writer & writer, const Dictionary & dictionary, bool checksum);
+
+/**
+ * Decodes the body of the dictionary section.
+ *
+ * @param body the body that should outlive the dictionary.
+ * @param count the number of entries.
+ * @return false if the body is malformed.
+ */
+bool decode_dictionary(std::string_view body, std::uint64_t count, Dictionary & dictionary);
+
+/**
+ * Reads a record of the version 1.
+ *
+ * @param data buffer that receives the payload.
+ * @param random index of the "random" node plus one, zero if there is no such node.
+ * @return false if the file has ended before the end of the record.
+ */
+bool read_record_v1(Reader & reader, std::string & data, std::uint64_t & random);
+
+/**
+ * Reads a block of the size declared by the stream. If the size of the source
+ * is unknown, the block is read by pieces into a growing buffer, so a corrupted
+ * size fails at the end of the source instead of allocating that much memory.
+ *
+ * @param size the declared size of the block.
+ * @param available the number of bytes left in the source or UNKNOWN_SIZE.
+ * @param out buffer that receives the block.
+ * @return false if the size exceeds available or the source has ended earlier.
+ */
+bool read_block(Reader & reader, std::uint64_t size, std::uint64_t available, std::vector<char> & out);
+
+/**
+ * Reads a block as read_block() does into memory that may be adopted by PayloadArena.
+ *
+ * @return the block or nullptr if the size exceeds available or the source has ended earlier.
+ */
+std::unique_ptr<char[]> read_block(Reader & reader, std::uint64_t size, std::uint64_t available);
+
+/**
+ * Decodes a single record.
+ *
+ * @param in pointer to the record, moved past it on success.
+ * @param end end of the frame body.
+ * @param dictionary the dictionary if the list is written with FLAG_DICTIONARY, else - nullptr.
+ * @return false if the record is malformed.
+ */
+inline bool decode_record(const char *& in, const char * end, std::string_view & data, std::uint64_t & random, const Dictionary * dictionary = nullptr)
+{
+    std::uint64_t length;
+    if (!get_varint(in, end, length)) {
+        return false;
+    }
+    if (dictionary) {
+        if (length >= dictionary->size()) {
+            return false;
+        }
+        data = (*dictionary)[length];
+    }
+    else {
+        if (length > static_cast<std::uint64_t>(end - in)) {
+            return false;
+        }
+        data = std::string_view(in, length);
+        in += length;
+    }
+    return get_varint(in, end, random);
+}
+
+/**
+ * Decodes the records of a frame body of the version 2.
+ *
+ * @param body the frame body.
+ * @param records the number of records in the frame.
+ * @param dictionary the dictionary if the list is written with FLAG_DICTIONARY, else - nullptr.
+ * @param visitor function called with the payload and the encoded "random" index of each record.
+ * @return false if the body is malformed.
+ */
+template <typename Visitor>
+bool decode_frame(std::string_view body, std::uint32_t records, const Dictionary * dictionary, Visitor && visitor)
+{
+    const auto * in = body.data();
+    const auto * end = in + body.size();
+    for (std::uint32_t i = 0; i < records; ++i) {
+        std::string_view data;
+        std::uint64_t random;
+        if (!decode_record(in, end, data, random, dictionary)) {
+            return false;
+        }
+        visitor(data, random);
+    }
+    return in == end;
+}
+
+template <typename Visitor>
+bool decode_frame(std::string_view body, std::uint32_t records, Visitor && visitor)
+{
+    return decode_frame(body, records, nullptr, std::forward<Visitor>(visitor));
+}
+
+} // namespace format
+
+} // namespace solution
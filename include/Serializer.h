@@ -0,0 +1,88 @@
+#pragma once
+
+#include "SerializationFormat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace solution {
+
+/**
+ * Encodings of the payloads of BasicList.
+ *
+ * Explanation for implementation.
+ *  - Serializer<T> is the customization point: specialize it for own
+ *    types with a static serialize(value, writer) and a static
+ *    deserialize(value, reader) returning false on failure.
+ *  - Trivially copyable types are written as their bytes in the
+ *    native byte order. Such serializers set BULK, so the list writes
+ *    and reads whole arrays of values at once.
+ *  - std::string is written as a varint length followed by the bytes.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+namespace serializers {
+
+template <typename T, typename = void>
+struct Serializer;
+
+template <typename T>
+struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+{
+    /**
+     * Arrays of values are written with a single write.
+     */
+    static constexpr bool BULK = true;
+
+    static void serialize(const T & value, format::Writer & writer)
+    {
+        writer.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static bool deserialize(T & value, format::Reader & reader)
+    {
+        return reader.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+};
+
+template <>
+struct Serializer<std::string>
+{
+    static constexpr bool BULK = false;
+
+    static void serialize(const std::string & value, format::Writer & writer)
+    {
+        char length[format::MAX_VARINT_SIZE];
+        writer.write(length, static_cast<std::size_t>(format::put_varint(length, value.size()) - length));
+        writer.write(value);
+    }
+
+    static bool deserialize(std::string & value, format::Reader & reader)
+    {
+        const auto prefix = reader.peek(format::MAX_VARINT_SIZE);
+        const auto * in = prefix.data();
+        std::uint64_t length;
+        if (!format::get_varint(in, prefix.data() + prefix.size(), length)) {
+            return false;
+        }
+        char skipped[format::MAX_VARINT_SIZE];
+        reader.read(skipped, static_cast<std::size_t>(in - prefix.data()));
+        // A corrupted length must not allocate more than the source holds
+        value.clear();
+        while (value.size() < length) {
+            const auto size = value.size();
+            const auto step = std::min<std::uint64_t>(length - size, format::FRAME_SIZE);
+            value.resize(size + step);
+            if (!reader.read(value.data() + size, step)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace serializers
+
+} // namespace solution
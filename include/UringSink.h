@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Io.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace solution::io {
+
+/**
+ * Sink that writes a new file with asynchronous direct I/O.
+ *
+ * Explanation for implementation.
+ *  - The file is opened with O_DIRECT, so the data does not pass through
+ *    the page cache. If the file system does not support it, the file is
+ *    opened as usual.
+ *  - Bytes are gathered in two aligned buffers: while one of them is
+ *    written by the kernel (io_uring), the other one is filled. Without
+ *    io_uring or its write operation (Linux 5.6) the buffers are written
+ *    synchronously with pwrite().
+ *  - Direct writes must have aligned lengths, so flush() writes the last
+ *    incomplete block padded with zeros and truncates the file to its
+ *    real size. The block stays buffered and is written once more when
+ *    it is completed.
+ *
+ * @author Igor Podtsepko (i.podtsepko2002@gmail.com)
+ */
+class UringSink final : public Sink
+{
+public:
+    /**
+     * Creates or truncates the file.
+     *
+     * @param path path to the file.
+     * @param buffer_size the size of each of two buffers, rounded up to the alignment.
+     */
+    explicit UringSink(const char * path, std::size_t buffer_size = 1 << 20);
+    ~UringSink() override;
+
+    UringSink(const UringSink &) = delete;
+    UringSink & operator=(const UringSink &) = delete;
+
+    bool write(const char * data, std::size_t size) override;
+    bool flush() override;
+
+    /**
+     * @return false if the file is not opened or some write has failed.
+     */
+    bool good() const noexcept { return m_good; }
+
+    /**
+     * @return true if the page cache is bypassed.
+     */
+    bool direct() const noexcept { return m_direct; }
+
+    /**
+     * @return true if the buffers are written with io_uring.
+     */
+    bool asynchronous() const noexcept { return m_ring != nullptr; }
+
+    /**
+     * The alignment of the buffers, of the offsets and of the lengths of writes.
+     */
+    static constexpr std::size_t ALIGNMENT = 4096;
+
+private:
+    struct Ring;
+
+    struct Free
+    {
+        void operator()(char * buffer) const noexcept;
+    };
+
+    /**
+     * Starts writing the first size bytes of the buffer at the offset.
+     */
+    void submit(std::size_t buffer, std::size_t size, std::uint64_t offset);
+
+    /**
+     * Waits until the buffer can be changed.
+     */
+    void wait(std::size_t buffer);
+
+    int m_fd = -1;
+    bool m_good = false;
+    bool m_direct = false;
+    std::unique_ptr<Ring> m_ring;
+
+    std::unique_ptr<char, Free> m_buffers[2];
+    /**
+     * The expected results of the writes in progress, zero for idle buffers.
+     */
+    std::size_t m_pending[2] = {0, 0};
+    std::size_t m_capacity;
+    std::size_t m_current = 0;
+    std::size_t m_used = 0;
+    /**
+     * The offset of the current buffer in the file.
+     */
+    std::uint64_t m_offset = 0;
+};
+
+} // namespace solution::io
@@ -0,0 +1,148 @@
+#include "Checksum.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace solution::checksum {
+
+namespace {
+
+constexpr std::uint32_t POLYNOMIAL = 0x82f63b78; // Reversed
+
+using Tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr Tables make_tables()
+{
+    Tables tables{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        auto crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? POLYNOMIAL : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (std::size_t table = 1; table < tables.size(); ++table) {
+        for (std::size_t i = 0; i < 256; ++i) {
+            const auto previous = tables[table - 1][i];
+            tables[table][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+    }
+    return tables;
+}
+
+constexpr Tables TABLES = make_tables();
+
+[[maybe_unused]] std::uint64_t load64(const unsigned char * in)
+{
+    std::uint64_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+std::uint32_t update_portable(std::uint32_t crc, const unsigned char * in, std::size_t size)
+{
+    for (; size >= 8; size -= 8, in += 8) {
+        // Little-endian order of the bytes
+        std::uint32_t low = crc;
+        std::uint32_t high = 0;
+        for (int i = 0; i < 4; ++i) {
+            low ^= static_cast<std::uint32_t>(in[i]) << (8 * i);
+            high |= static_cast<std::uint32_t>(in[4 + i]) << (8 * i);
+        }
+        crc = TABLES[7][low & 0xff] ^ TABLES[6][(low >> 8) & 0xff] ^
+                TABLES[5][(low >> 16) & 0xff] ^ TABLES[4][low >> 24] ^
+                TABLES[3][high & 0xff] ^ TABLES[2][(high >> 8) & 0xff] ^
+                TABLES[1][(high >> 16) & 0xff] ^ TABLES[0][high >> 24];
+    }
+    for (; size != 0; --size, ++in) {
+        crc = (crc >> 8) ^ TABLES[0][(crc ^ *in) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) std::uint32_t update_accelerated(std::uint32_t crc, const unsigned char * in, std::size_t size)
+{
+    std::uint64_t value = crc;
+    for (; size >= 8; size -= 8, in += 8) {
+        value = _mm_crc32_u64(value, load64(in));
+    }
+    crc = static_cast<std::uint32_t>(value);
+    for (; size != 0; --size, ++in) {
+        crc = _mm_crc32_u8(crc, *in);
+    }
+    return crc;
+}
+
+bool supported()
+{
+    return __builtin_cpu_supports("sse4.2");
+}
+
+#elif defined(__aarch64__) && defined(__linux__)
+
+__attribute__((target("+crc"))) std::uint32_t update_accelerated(std::uint32_t crc, const unsigned char * in, std::size_t size)
+{
+    for (; size >= 8; size -= 8, in += 8) {
+        crc = __crc32cd(crc, load64(in));
+    }
+    for (; size != 0; --size, ++in) {
+        crc = __crc32cb(crc, *in);
+    }
+    return crc;
+}
+
+bool supported()
+{
+    return getauxval(AT_HWCAP) & HWCAP_CRC32;
+}
+
+#else
+
+std::uint32_t update_accelerated(std::uint32_t crc, const unsigned char * in, std::size_t size)
+{
+    return update_portable(crc, in, size);
+}
+
+bool supported()
+{
+    return false;
+}
+
+#endif
+
+using Update = std::uint32_t (*)(std::uint32_t, const unsigned char *, std::size_t);
+
+Update select()
+{
+    static const Update update = supported() ? update_accelerated : update_portable;
+    return update;
+}
+
+} // namespace
+
+std::uint32_t crc32c(const char * data, const std::size_t size, const std::uint32_t crc)
+{
+    return ~select()(~crc, reinterpret_cast<const unsigned char *>(data), size);
+}
+
+std::uint32_t crc32c_portable(const char * data, const std::size_t size, const std::uint32_t crc)
+{
+    return ~update_portable(~crc, reinterpret_cast<const unsigned char *>(data), size);
+}
+
+bool accelerated()
+{
+    return supported();
+}
+
+} // namespace solution::checksum
@@ -0,0 +1,164 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace solution::lz {
+
+namespace {
+
+constexpr unsigned HASH_LOG = 12;
+constexpr std::size_t MAX_DISTANCE = 0xffff;
+/**
+ * The last bytes of a block are always literals, so the search of matches never reads past the end.
+ */
+constexpr std::size_t LAST_LITERALS = 8;
+constexpr unsigned SKIP_TRIGGER = 6;
+
+std::uint32_t load32(const unsigned char * in)
+{
+    std::uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash(std::uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+unsigned char * put_length(unsigned char * out, std::size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        *(out++) = 255;
+    }
+    *(out++) = static_cast<unsigned char>(length);
+    return out;
+}
+
+unsigned char * put_command(unsigned char * out, const unsigned char * literals, std::size_t count, std::size_t distance, std::size_t match)
+{
+    auto * token = out++;
+    *token = static_cast<unsigned char>(std::min<std::size_t>(count, 15) << 4);
+    if (count >= 15) {
+        out = put_length(out, count - 15);
+    }
+    std::memcpy(out, literals, count);
+    out += count;
+    if (match == 0) {
+        return out;
+    }
+    *(out++) = static_cast<unsigned char>(distance);
+    *(out++) = static_cast<unsigned char>(distance >> 8);
+    match -= MIN_MATCH;
+    *token |= static_cast<unsigned char>(std::min<std::size_t>(match, 15));
+    if (match >= 15) {
+        out = put_length(out, match - 15);
+    }
+    return out;
+}
+
+bool get_length(const unsigned char *& in, const unsigned char * end, std::size_t & length)
+{
+    if (length != 15) {
+        return true;
+    }
+    for (unsigned char byte = 255; byte == 255;) {
+        if (in == end) {
+            return false;
+        }
+        byte = *(in++);
+        length += byte;
+    }
+    return true;
+}
+
+} // namespace
+
+std::size_t compress(const char * data, const std::size_t size, char * result)
+{
+    const auto * begin = reinterpret_cast<const unsigned char *>(data);
+    const auto * end = begin + size;
+    auto * out = reinterpret_cast<unsigned char *>(result);
+    const auto * anchor = begin;
+    if (size > LAST_LITERALS + MIN_MATCH) {
+        std::uint32_t table[1 << HASH_LOG] = {};
+        const auto * limit = end - LAST_LITERALS;
+        for (auto * in = begin + 1; in + MIN_MATCH <= limit;) {
+            const auto sequence = load32(in);
+            auto & entry = table[hash(sequence)];
+            const auto * match = begin + entry;
+            entry = static_cast<std::uint32_t>(in - begin);
+            if (static_cast<std::size_t>(in - match) > MAX_DISTANCE || load32(match) != sequence) {
+                // The step grows on data without matches
+                in += 1 + (static_cast<std::size_t>(in - anchor) >> SKIP_TRIGGER);
+                continue;
+            }
+            while (in > anchor && match > begin && in[-1] == match[-1]) {
+                --in;
+                --match;
+            }
+            auto length = MIN_MATCH;
+            while (in + length < limit && in[length] == match[length]) {
+                ++length;
+            }
+            out = put_command(out, anchor, static_cast<std::size_t>(in - anchor), static_cast<std::size_t>(in - match), length);
+            in += length;
+            anchor = in;
+        } // O(size)
+    }
+    out = put_command(out, anchor, static_cast<std::size_t>(end - anchor), 0, 0);
+    return static_cast<std::size_t>(out - reinterpret_cast<unsigned char *>(result));
+}
+
+bool decompress(const char * data, const std::size_t size, char * result, const std::size_t capacity)
+{
+    const auto * in = reinterpret_cast<const unsigned char *>(data);
+    const auto * end = in + size;
+    auto * begin = reinterpret_cast<unsigned char *>(result);
+    auto * out = begin;
+    auto * out_end = begin + capacity;
+    while (in != end) {
+        const auto token = *(in++);
+        std::size_t count = token >> 4;
+        if (!get_length(in, end, count) ||
+            count > static_cast<std::size_t>(end - in) ||
+            count > static_cast<std::size_t>(out_end - out)) {
+            return false;
+        }
+        std::memcpy(out, in, count);
+        in += count;
+        out += count;
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        const auto distance = static_cast<std::size_t>(in[0] | (in[1] << 8));
+        in += 2;
+        std::size_t length = token & 15;
+        if (!get_length(in, end, length) ||
+            distance == 0 || distance > static_cast<std::size_t>(out - begin) ||
+            length + MIN_MATCH > static_cast<std::size_t>(out_end - out)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        const auto * match = out - distance;
+        if (distance >= length) {
+            std::memcpy(out, match, length);
+            out += length;
+        }
+        else {
+            // Overlapping match repeats the last distance bytes
+            for (const auto * last = out + length; out != last;) {
+                *(out++) = *(match++);
+            }
+        }
+    } // O(capacity)
+    return out == out_end;
+}
+
+} // namespace solution::lz
@@ -0,0 +1,268 @@
+#include "ConcurrentList.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace solution {
+
+namespace {
+
+/**
+ * A place of guards taken by the calling thread, nested guards share it.
+ */
+struct Entered
+{
+    const void * m_list;
+    std::size_t m_slot;
+    std::size_t m_depth;
+};
+
+thread_local std::vector<Entered> entered;
+
+} // namespace
+
+void ConcurrentList::SpinLock::lock() noexcept
+{
+    while (m_flag.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+ConcurrentList::ConcurrentList()
+    : m_guards(std::make_unique<GuardSlot[]>(MAX_GUARDS))
+{
+    m_head.m_next.store(&m_tail, std::memory_order_relaxed);
+    m_tail.m_previous.store(&m_head, std::memory_order_relaxed);
+    // Sentinels are never erased
+    m_head.m_generation.store(1, std::memory_order_relaxed);
+    m_tail.m_generation.store(1, std::memory_order_relaxed);
+}
+
+ConcurrentList::~ConcurrentList() = default;
+
+ConcurrentList::Guard::Guard(const ConcurrentList & list)
+    : m_list(list)
+    , m_slot(list.enter())
+{
+}
+
+ConcurrentList::Guard::~Guard()
+{
+    m_list.leave(m_slot);
+}
+
+std::size_t ConcurrentList::enter() const
+{
+    // Nested guards share the place, otherwise threads holding all places could not modify the list
+    const auto it = std::find_if(entered.begin(), entered.end(), [this](const Entered & place) { return place.m_list == this; });
+    if (it != entered.end()) {
+        ++it->m_depth;
+        return it->m_slot;
+    }
+    entered.reserve(entered.size() + 1);
+    const auto first = std::hash<std::thread::id>()(std::this_thread::get_id());
+    while (true) {
+        // An outdated epoch only delays reclamation
+        const auto state = (m_epoch.load() << 1) | 1;
+        for (std::size_t i = 0; i < MAX_GUARDS; ++i) {
+            const auto slot = (first + i) % MAX_GUARDS;
+            std::uint64_t expected = 0;
+            if (m_guards[slot].m_state.compare_exchange_strong(expected, state)) {
+                entered.push_back({this, slot, 1});
+                return slot;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ConcurrentList::leave(const std::size_t slot) const noexcept
+{
+    const auto it = std::find_if(entered.begin(), entered.end(), [this](const Entered & place) { return place.m_list == this; });
+    if (--it->m_depth == 0) {
+        entered.erase(it);
+        m_guards[slot].m_state.store(0, std::memory_order_release);
+    }
+}
+
+ConcurrentList::Node * ConcurrentList::lock_previous(Node * position) noexcept
+{
+    while (true) {
+        auto * previous = position->m_previous.load(std::memory_order_acquire);
+        previous->m_lock.lock();
+        position->m_lock.lock();
+        if (!alive(position->m_generation.load(std::memory_order_relaxed))) {
+            position->m_lock.unlock();
+            previous->m_lock.unlock();
+            return nullptr;
+        }
+        // Erased nodes keep their links, so the previous node has to be checked as well
+        if (previous->m_next.load(std::memory_order_relaxed) == position && alive(previous->m_generation.load(std::memory_order_relaxed))) {
+            return previous;
+        }
+        position->m_lock.unlock();
+        previous->m_lock.unlock();
+    }
+}
+
+bool ConcurrentList::link_before(Node * position, Node * node) noexcept
+{
+    auto * previous = lock_previous(position);
+    if (!previous) {
+        return false;
+    }
+    node->m_previous.store(previous, std::memory_order_relaxed);
+    node->m_next.store(position, std::memory_order_relaxed);
+    // Publishes the payload as well
+    previous->m_next.store(node, std::memory_order_release);
+    position->m_previous.store(node, std::memory_order_release);
+    position->m_lock.unlock();
+    previous->m_lock.unlock();
+    m_size.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+ConcurrentList::ConstIterator ConcurrentList::insert(ConstIterator position, std::string data)
+{
+    Guard guard(*this);
+    auto * node = create(std::move(data));
+    if (!link_before(position.m_node, node)) {
+        retire(node);
+        return end();
+    }
+    return {this, node};
+}
+
+ConcurrentList::ConstIterator ConcurrentList::push_front(std::string data)
+{
+    // The first node is read under the guard, so it is not reused until the node is linked
+    Guard guard(*this);
+    auto * node = create(std::move(data));
+    // If the first node has been erased, its follower is the first one now
+    while (!link_before(m_head.m_next.load(std::memory_order_acquire), node)) {
+    }
+    return {this, node};
+}
+
+bool ConcurrentList::erase(ConstIterator position)
+{
+    auto * node = position.m_node;
+    if (node == &m_head || node == &m_tail) {
+        return false;
+    }
+    Guard guard(*this);
+    auto * previous = lock_previous(node);
+    if (!previous) {
+        return false;
+    }
+    // The next node cannot be erased or separated from this one while this one is locked
+    auto * next = node->m_next.load(std::memory_order_relaxed);
+    next->m_lock.lock();
+    node->m_generation.fetch_add(1);
+    previous->m_next.store(next, std::memory_order_release);
+    next->m_previous.store(previous, std::memory_order_release);
+    next->m_lock.unlock();
+    node->m_lock.unlock();
+    previous->m_lock.unlock();
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+    retire(node);
+    return true;
+}
+
+void ConcurrentList::link(ConstIterator position, ConstIterator random) noexcept
+{
+    std::uint64_t value = 0;
+    if (random.m_node != &m_tail) {
+        const std::uint64_t generation = random.m_node->m_generation.load();
+        value = (generation << 32) | (std::uint64_t{random.m_node->m_number} + 1);
+    }
+    position.m_node->m_random.store(value, std::memory_order_release);
+}
+
+ConcurrentList::Node * ConcurrentList::create(std::string data)
+{
+    Node * node;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()) {
+            node = m_free.back();
+            m_free.pop_back();
+        }
+        else {
+            if (m_allocated == std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("ConcurrentList: too many nodes");
+            }
+            const auto number = m_allocated++;
+            const auto chunk = 63 - static_cast<std::size_t>(__builtin_clzll(number / FIRST_CHUNK_SIZE + 1));
+            if (!m_storage[chunk]) {
+                m_storage[chunk].reset(new Node[FIRST_CHUNK_SIZE << chunk]);
+                m_chunks[chunk].store(m_storage[chunk].get(), std::memory_order_release);
+            }
+            node = this->node(number);
+            node->m_number = number;
+        }
+    }
+    // Nobody sees the node until it is published
+    node->m_data = std::move(data);
+    node->m_random.store(0, std::memory_order_relaxed);
+    node->m_generation.fetch_add(1, std::memory_order_release);
+    return node;
+}
+
+void ConcurrentList::retire(Node * node)
+{
+    if (alive(node->m_generation.load(std::memory_order_relaxed))) {
+        // Has not been published
+        node->m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retired.push_back({node, m_epoch.load()});
+    if (m_retired.size() >= RECLAIM_THRESHOLD) {
+        reclaim();
+    }
+}
+
+void ConcurrentList::reclaim()
+{
+    auto epoch = m_epoch.load();
+    bool quiescent = true;
+    for (std::size_t i = 0; i < MAX_GUARDS && quiescent; ++i) {
+        const auto state = m_guards[i].m_state.load();
+        quiescent = state == 0 || state >> 1 == epoch;
+    }
+    if (quiescent) {
+        m_epoch.store(++epoch);
+    }
+    // Guards that could see the nodes erased in the epoch e are entered in the epoch e or e + 1
+    auto it = m_retired.begin();
+    for (; it != m_retired.end() && it->m_epoch + 2 <= epoch; ++it) {
+        std::string().swap(it->m_node->m_data);
+        m_free.push_back(it->m_node);
+    }
+    m_retired.erase(m_retired.begin(), it);
+}
+
+ConcurrentList::Node * ConcurrentList::node(const std::uint32_t number) const noexcept
+{
+    const auto chunk = 63 - static_cast<std::size_t>(__builtin_clzll(number / FIRST_CHUNK_SIZE + 1));
+    const auto first = FIRST_CHUNK_SIZE * ((std::size_t{1} << chunk) - 1);
+    return m_chunks[chunk].load(std::memory_order_acquire) + (number - first);
+}
+
+ConcurrentList::Node * ConcurrentList::resolve(const std::uint64_t random) const noexcept
+{
+    if (random == 0) {
+        return &m_tail;
+    }
+    auto * node = this->node(static_cast<std::uint32_t>(random - 1));
+    const auto generation = node->m_generation.load();
+    if (generation != random >> 32 || !alive(generation)) {
+        return &m_tail;
+    }
+    return node;
+}
+
+} // namespace solution
@@ -0,0 +1,92 @@
+#include "Io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solution::io {
+
+bool FileSink::write(const char * data, const std::size_t size)
+{
+    return std::fwrite(data, sizeof(char), size, m_file) == size;
+}
+
+std::size_t FileSource::read(char * data, const std::size_t size)
+{
+    return std::fread(data, sizeof(char), size, m_file);
+}
+
+std::uint64_t FileSource::remaining()
+{
+    const auto position = std::ftell(m_file);
+    if (position < 0 || std::fseek(m_file, 0, SEEK_END) != 0) {
+        return UNKNOWN_SIZE;
+    }
+    const auto end = std::ftell(m_file);
+    std::fseek(m_file, position, SEEK_SET);
+    return end < position ? 0 : static_cast<std::uint64_t>(end - position);
+}
+
+void FileSource::unread(const std::size_t count)
+{
+    std::fseek(m_file, -static_cast<long>(count), SEEK_CUR);
+}
+
+bool FdSink::write(const char * data, std::size_t size)
+{
+    while (size != 0) {
+        const auto result = ::write(m_fd, data, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        data += result;
+        size -= static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+std::size_t FdSource::read(char * data, const std::size_t size)
+{
+    std::size_t received = 0;
+    while (received < size) {
+        const auto result = ::read(m_fd, data + received, size - received);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        received += static_cast<std::size_t>(result);
+    }
+    return received;
+}
+
+std::uint64_t FdSource::remaining()
+{
+    struct stat status;
+    const auto position = lseek(m_fd, 0, SEEK_CUR);
+    if (position < 0 || fstat(m_fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+        return UNKNOWN_SIZE;
+    }
+    return status.st_size < position ? 0 : static_cast<std::uint64_t>(status.st_size - position);
+}
+
+void FdSource::unread(const std::size_t count)
+{
+    lseek(m_fd, -static_cast<off_t>(count), SEEK_CUR);
+}
+
+std::size_t MemorySource::read(char * data, const std::size_t size)
+{
+    const auto count = std::min(size, m_size - m_position);
+    std::memcpy(data, m_data + m_position, count);
+    m_position += count;
+    return count;
+}
+
+} // namespace solution::io
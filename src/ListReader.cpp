@@ -0,0 +1,188 @@
+#include "ListReader.h"
+
+#include <algorithm>
+
+namespace solution {
+
+namespace {
+
+bool read_at(file_ptr_t file, long position, char * data, std::size_t size)
+{
+    return std::fseek(file, position, SEEK_SET) == 0 && std::fread(data, sizeof(char), size, file) == size;
+}
+
+} // namespace
+
+int ListReader::open(file_ptr_t file)
+{
+    if (!file) {
+        return -1;
+    }
+    m_file = file;
+    m_base = std::ftell(file);
+    m_frames.clear();
+    m_loaded = false;
+    char buffer[format::HEADER_SIZE];
+    if (m_base < 0 || !read_at(file, m_base, buffer, sizeof(buffer))) {
+        return 1;
+    }
+    if (!m_header.decode(buffer)) {
+        return 2;
+    }
+    std::uint64_t frames_offset = format::HEADER_SIZE;
+    if (dictionary()) {
+        char section[format::DICTIONARY_HEADER_SIZE];
+        if (std::fread(section, sizeof(char), sizeof(section), file) != sizeof(section)) {
+            return 1;
+        }
+        // Sizes come from the file, so they are checked before anything is allocated
+        const auto size = format::get_integer<std::uint64_t>(section + 8);
+        if (size > io::FileSource(file).remaining()) {
+            return 1;
+        }
+        m_entries.resize(size);
+        std::string_view body(m_entries.data(), m_entries.size());
+        if (std::fread(m_entries.data(), sizeof(char), m_entries.size(), file) != m_entries.size() ||
+            ((m_header.m_flags & format::FLAG_CHECKSUM) && !format::verify_checksum(body)) ||
+            !format::decode_dictionary(body, format::get_integer<std::uint64_t>(section), m_dictionary)) {
+            return 1;
+        }
+        frames_offset += format::DICTIONARY_HEADER_SIZE + m_entries.size();
+    }
+
+    if (indexed()) {
+        char footer[format::FOOTER_SIZE];
+        if (std::fseek(file, -static_cast<long>(format::FOOTER_SIZE), SEEK_END) != 0 ||
+            std::fread(footer, sizeof(char), sizeof(footer), file) != sizeof(footer) ||
+            std::string_view(footer + 8, format::MAGIC.size()) != format::MAGIC) {
+            return 1;
+        }
+        const auto index = m_base + static_cast<long>(format::get_integer<std::uint64_t>(footer));
+        if (!read_at(file, index, buffer, sizeof(std::uint64_t))) {
+            return 1;
+        }
+        const auto frames = format::get_integer<std::uint64_t>(buffer);
+        if (frames > m_header.m_count || frames > io::FileSource(file).remaining() / format::FRAME_ENTRY_SIZE) {
+            return 1;
+        }
+        std::vector<char> table(frames * format::FRAME_ENTRY_SIZE);
+        if (std::fread(table.data(), sizeof(char), table.size(), file) != table.size()) {
+            return 1;
+        }
+        m_frames.reserve(frames);
+        for (std::size_t i = 0; i < frames; ++i) {
+            const auto * entry = table.data() + i * format::FRAME_ENTRY_SIZE;
+            m_frames.push_back({format::get_integer<std::uint64_t>(entry), format::get_integer<std::uint64_t>(entry + 8)});
+        }
+        m_offsets = index + static_cast<long>(sizeof(std::uint64_t) + table.size());
+        return 0;
+    }
+
+    auto offset = frames_offset;
+    for (std::uint64_t first = 0; first < m_header.m_count;) {
+        char frame[format::FRAME_HEADER_SIZE];
+        if (!read_at(file, m_base + static_cast<long>(offset), frame, sizeof(frame))) {
+            return 1;
+        }
+        const auto records = format::get_integer<std::uint32_t>(frame);
+        if (records == 0) {
+            return 1;
+        }
+        m_frames.push_back({offset, first});
+        first += records;
+        offset += format::FRAME_HEADER_SIZE + format::get_integer<std::uint32_t>(frame + 4);
+    }
+    return 0;
+}
+
+bool ListReader::load_frame(const std::size_t frame)
+{
+    if (m_loaded && m_frame == frame) {
+        return true;
+    }
+    m_loaded = false;
+    char header[format::FRAME_HEADER_SIZE];
+    if (!read_at(m_file, m_base + static_cast<long>(m_frames[frame].m_offset), header, sizeof(header))) {
+        return false;
+    }
+    m_body.resize(format::get_integer<std::uint32_t>(header + 4));
+    if (std::fread(m_body.data(), sizeof(char), m_body.size(), m_file) != m_body.size() ||
+        !format::unpack_frame(m_header.m_flags, m_body, m_buffer)) {
+        return false;
+    }
+    m_frame = frame;
+    m_loaded = true;
+    return true;
+}
+
+bool ListReader::seek(const std::uint64_t index, std::uint32_t & offset)
+{
+    const auto found = std::upper_bound(m_frames.begin(), m_frames.end(), index, [](std::uint64_t value, const format::FrameEntry & entry) {
+        return value < entry.m_first;
+    });
+    if (found == m_frames.begin() || !load_frame(found - m_frames.begin() - 1)) {
+        return false;
+    }
+    auto skip = index - m_frames[m_frame].m_first;
+    if (indexed()) {
+        char buffer[sizeof(std::uint32_t)];
+        if (!read_at(m_file, m_offsets + static_cast<long>(index * sizeof(std::uint32_t)), buffer, sizeof(buffer))) {
+            return false;
+        }
+        offset = format::get_integer<std::uint32_t>(buffer);
+        return offset < m_body.size();
+    }
+    const auto * in = m_body.data();
+    const auto * end = in + m_body.size();
+    for (; skip != 0; --skip) {
+        std::string_view data;
+        std::uint64_t random;
+        if (!format::decode_record(in, end, data, random, dictionary())) {
+            return false;
+        }
+    }
+    offset = static_cast<std::uint32_t>(in - m_body.data());
+    return true;
+}
+
+int ListReader::read(const std::uint64_t index, Element & element)
+{
+    std::vector<Element> elements;
+    const auto status = read(index, index + 1, elements);
+    if (status == 0) {
+        element = std::move(elements.front());
+    }
+    return status;
+}
+
+int ListReader::read(const std::uint64_t first, const std::uint64_t last, std::vector<Element> & elements)
+{
+    if (!m_file || first > last || last > size()) {
+        return -1;
+    }
+    if (first == last) {
+        return 0;
+    }
+    std::uint32_t offset;
+    if (!seek(first, offset)) {
+        return 1;
+    }
+    const auto * in = m_body.data() + offset;
+    for (auto index = first; index < last; ++index) {
+        if (in == m_body.data() + m_body.size()) {
+            if (m_frame + 1 == m_frames.size() || !load_frame(m_frame + 1)) {
+                return 1;
+            }
+            in = m_body.data();
+        }
+        std::string_view data;
+        std::uint64_t random;
+        if (!format::decode_record(in, m_body.data() + m_body.size(), data, random, dictionary())) {
+            return 1;
+        }
+        elements.push_back({std::string(data), random == 0 ? NO_RANDOM : random - 1});
+    }
+    return 0;
+}
+
+} // namespace solution
@@ -0,0 +1,120 @@
+#include "ListStream.h"
+
+namespace solution {
+
+int ListStream::open(file_ptr_t file)
+{
+    if (!file) {
+        return m_status = -1;
+    }
+    m_reader.reset();
+    m_source = std::make_unique<io::FileSource>(file);
+    m_available = m_source->remaining();
+    m_reader.emplace(*m_source);
+    return start();
+}
+
+int ListStream::open(const int fd)
+{
+    if (fd < 0) {
+        return m_status = -1;
+    }
+    m_reader.reset();
+    m_source = std::make_unique<io::FdSource>(fd);
+    m_available = m_source->remaining();
+    m_reader.emplace(*m_source);
+    return start();
+}
+
+int ListStream::open(io::Source & source)
+{
+    m_reader.reset();
+    m_source.reset();
+    m_available = source.remaining();
+    m_reader.emplace(source);
+    return start();
+}
+
+int ListStream::start()
+{
+    m_index = 0;
+    m_records = 0;
+    m_body.clear();
+    m_position = nullptr;
+    if (m_reader->peek(format::MAGIC.size()) != format::MAGIC) {
+        m_version = format::VERSION_1;
+        m_size = UNKNOWN_SIZE;
+        return m_status = 0;
+    }
+    char buffer[format::HEADER_SIZE];
+    format::Header header;
+    if (!m_reader->read(buffer, sizeof(buffer)) || !header.decode(buffer)) {
+        return stop(2);
+    }
+    m_version = format::VERSION_2;
+    m_size = header.m_count;
+    m_flags = header.m_flags;
+    if (m_flags & format::FLAG_DICTIONARY) {
+        char section[format::DICTIONARY_HEADER_SIZE];
+        if (!m_reader->read(section, sizeof(section))) {
+            return stop(1);
+        }
+        if (!format::read_block(*m_reader, format::get_integer<std::uint64_t>(section + 8), m_available, m_entries)) {
+            return stop(1);
+        }
+        std::string_view body(m_entries.data(), m_entries.size());
+        if (((m_flags & format::FLAG_CHECKSUM) && !format::verify_checksum(body)) ||
+            !format::decode_dictionary(body, format::get_integer<std::uint64_t>(section), m_dictionary)) {
+            return stop(1);
+        }
+    }
+    return m_status = 0;
+}
+
+bool ListStream::next(Element & element)
+{
+    if (m_status != 0 || !m_reader) {
+        return false;
+    }
+    std::uint64_t random;
+    if (m_version == format::VERSION_1) {
+        if (m_reader->peek(1).empty()) {
+            stop(0);
+            return false;
+        }
+        if (!format::read_record_v1(*m_reader, m_payload, random)) {
+            return fail(1);
+        }
+        element.m_data = m_payload;
+    }
+    else {
+        if (m_index == m_size) {
+            stop(0);
+            return false;
+        }
+        if (m_records == 0) {
+            char frame[format::FRAME_HEADER_SIZE];
+            if (!m_reader->read(frame, sizeof(frame))) {
+                return fail(1);
+            }
+            m_records = format::get_integer<std::uint32_t>(frame);
+            if (m_records == 0 || m_records > m_size - m_index ||
+                !format::read_block(*m_reader, format::get_integer<std::uint32_t>(frame + 4), m_available, m_body) ||
+                !format::unpack_frame(m_flags, m_body, m_buffer)) {
+                return fail(1);
+            }
+            m_position = m_body.data();
+        }
+        const auto * end = m_body.data() + m_body.size();
+        if (!format::decode_record(m_position, end, element.m_data, random, m_flags & format::FLAG_DICTIONARY ? &m_dictionary : nullptr) ||
+            random > m_size ||
+            (--m_records == 0 && m_position != end)) {
+            return fail(1);
+        }
+    }
+    element.m_random = random == 0 ? NO_RANDOM : random - 1;
+    ++m_index;
+    return true;
+}
+
+} // namespace solution
@@ -0,0 +1,169 @@
+#include "ListView.h"
+
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace solution {
+
+ListView::~ListView()
+{
+    close();
+}
+
+int ListView::open(file_ptr_t file)
+{
+    if (!file) {
+        return -1;
+    }
+    close();
+    const auto base = std::ftell(file);
+    struct stat status;
+    if (base < 0 || fstat(fileno(file), &status) != 0) {
+        return 1;
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    if (size < static_cast<std::size_t>(base) + format::HEADER_SIZE + format::FOOTER_SIZE) {
+        return 1;
+    }
+    auto * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (mapping == MAP_FAILED) {
+        return 1;
+    }
+    m_mapping = mapping;
+    m_mapping_size = size;
+    m_begin = static_cast<const char *>(mapping) + base;
+    m_end = static_cast<const char *>(mapping) + size;
+
+    if (!m_header.decode(m_begin) || !(m_header.m_flags & format::FLAG_INDEX) || (m_header.m_flags & format::FLAG_COMPRESSED)) {
+        close();
+        return 2;
+    }
+    const auto * footer = m_end - format::FOOTER_SIZE;
+    const auto index = format::get_integer<std::uint64_t>(footer);
+    if (std::string_view(footer + 8, format::MAGIC.size()) != format::MAGIC ||
+        index > static_cast<std::uint64_t>(footer - m_begin) - sizeof(std::uint64_t)) {
+        close();
+        return 1;
+    }
+    m_frames = m_begin + index + sizeof(std::uint64_t);
+    m_frame_count = format::get_integer<std::uint64_t>(m_begin + index);
+    const auto available = static_cast<std::uint64_t>(footer - m_frames);
+    if (m_frame_count > available / format::FRAME_ENTRY_SIZE ||
+        m_header.m_count > (available - m_frame_count * format::FRAME_ENTRY_SIZE) / sizeof(std::uint32_t) ||
+        (m_frame_count == 0 && m_header.m_count != 0)) {
+        close();
+        return 1;
+    }
+    m_offsets = m_frames + m_frame_count * format::FRAME_ENTRY_SIZE;
+
+    if (dictionary()) {
+        const auto * section = m_begin + format::HEADER_SIZE;
+        if (static_cast<std::uint64_t>(m_end - section) < format::DICTIONARY_HEADER_SIZE) {
+            close();
+            return 1;
+        }
+        const auto * entries = section + format::DICTIONARY_HEADER_SIZE;
+        const auto size = format::get_integer<std::uint64_t>(section + 8);
+        std::string_view body(entries, std::min(size, static_cast<std::uint64_t>(m_end - entries)));
+        if (size > static_cast<std::uint64_t>(m_end - entries) ||
+            ((m_header.m_flags & format::FLAG_CHECKSUM) && !format::verify_checksum(body)) ||
+            !format::decode_dictionary(body, format::get_integer<std::uint64_t>(section), m_dictionary)) {
+            close();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void ListView::close() noexcept
+{
+    if (m_mapping) {
+        munmap(m_mapping, m_mapping_size);
+    }
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_begin = m_end = nullptr;
+    m_header = {};
+    m_frames = m_offsets = nullptr;
+    m_frame_count = 0;
+    m_dictionary.clear();
+}
+
+std::uint64_t ListView::frame_first(const std::uint64_t number) const
+{
+    return format::get_integer<std::uint64_t>(m_frames + number * format::FRAME_ENTRY_SIZE + 8);
+}
+
+std::pair<const char *, const char *> ListView::frame(const std::uint64_t number) const
+{
+    const auto offset = format::get_integer<std::uint64_t>(m_frames + number * format::FRAME_ENTRY_SIZE);
+    if (offset > static_cast<std::uint64_t>(m_end - m_begin) - format::FRAME_HEADER_SIZE) {
+        return {m_end, m_end};
+    }
+    const auto * body = m_begin + offset + format::FRAME_HEADER_SIZE;
+    auto size = format::get_integer<std::uint32_t>(body - format::FRAME_HEADER_SIZE + 4);
+    // Checksums are not verified, reading a single element would cost reading the whole frame
+    if (m_header.m_flags & format::FLAG_CHECKSUM) {
+        size = size < format::CHECKSUM_SIZE ? 0 : size - format::CHECKSUM_SIZE;
+    }
+    return {body, size > static_cast<std::uint64_t>(m_end - body) ? m_end : body + size};
+}
+
+ListView::ConstIterator ListView::at(const std::uint64_t index) const
+{
+    ConstIterator iterator;
+    iterator.m_view = this;
+    iterator.m_index = std::min(index, size());
+    if (iterator.m_index == size()) {
+        return iterator;
+    }
+    // The last frame whose first record is not greater than the index
+    std::uint64_t low = 0;
+    std::uint64_t high = m_frame_count;
+    while (high - low > 1) {
+        const auto middle = low + (high - low) / 2;
+        if (frame_first(middle) <= index) {
+            low = middle;
+        }
+        else {
+            high = middle;
+        }
+    }
+    const auto [body, end] = frame(low);
+    const auto offset = format::get_integer<std::uint32_t>(m_offsets + index * sizeof(std::uint32_t));
+    iterator.m_frame = low;
+    iterator.m_frame_end = end;
+    iterator.decode(offset < static_cast<std::uint64_t>(end - body) ? body + offset : end);
+    return iterator;
+}
+
+void ListView::ConstIterator::decode(const char * record)
+{
+    std::uint64_t random;
+    if (!format::decode_record(record, m_frame_end, m_data, random, m_view->dictionary())) {
+        m_data = {};
+        random = 0;
+    }
+    m_next_record = record;
+    m_random = random == 0 || random > m_view->size() ? m_view->size() : random - 1;
+}
+
+ListView::ConstIterator & ListView::ConstIterator::operator++()
+{
+    ++m_index;
+    if (m_index >= m_view->size()) {
+        *this = m_view->end();
+    }
+    else if (m_next_record == m_frame_end && m_frame + 1 < m_view->m_frame_count) {
+        const auto [body, end] = m_view->frame(++m_frame);
+        m_frame_end = end;
+        decode(body);
+    }
+    else {
+        decode(m_next_record);
+    }
+    return *this;
+}
+
+} // namespace solution
@@ -0,0 +1,185 @@
+#include "OrderIndex.h"
+
+#include <algorithm>
+
+namespace solution {
+
+void OrderIndex::assign(const std::vector<std::size_t> & ids)
+{
+    m_root = NIL;
+    if (ids.empty()) {
+        return;
+    }
+    reserve(*std::max_element(ids.begin(), ids.end()) + 1);
+    // Cartesian tree of the priorities: the right spine is kept on the stack
+    std::vector<std::uint32_t> spine;
+    for (const auto value : ids) {
+        const auto id = static_cast<std::uint32_t>(value);
+        m_left[id] = m_right[id] = NIL;
+        m_priority[id] = priority();
+        auto last = NIL;
+        while (!spine.empty() && m_priority[spine.back()] < m_priority[id]) {
+            last = spine.back();
+            spine.pop_back();
+        }
+        m_left[id] = last;
+        if (last != NIL) {
+            m_parent[last] = id;
+        }
+        m_parent[id] = spine.empty() ? NIL : spine.back();
+        if (!spine.empty()) {
+            m_right[spine.back()] = id;
+        }
+        spine.push_back(id);
+    } // O(n)
+    m_root = spine.front();
+    // Children precede their parents in the order of decreasing depth
+    std::vector<std::uint32_t> order{m_root};
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (const auto child : {m_left[order[i]], m_right[order[i]]}) {
+            if (child != NIL) {
+                order.push_back(child);
+            }
+        }
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        update(*it);
+    } // O(n)
+}
+
+void OrderIndex::insert(const std::size_t position, const std::size_t value)
+{
+    reserve(value + 1);
+    const auto id = static_cast<std::uint32_t>(value);
+    m_left[id] = m_right[id] = m_parent[id] = NIL;
+    m_count[id] = 1;
+    m_priority[id] = priority();
+    const auto [left, right] = split(m_root, position);
+    m_root = merge(merge(left, id), right);
+    m_parent[m_root] = NIL;
+}
+
+void OrderIndex::erase(const std::size_t id)
+{
+    const auto first = position(id);
+    erase(first, first + 1);
+}
+
+void OrderIndex::erase(const std::size_t first, const std::size_t last)
+{
+    const auto [left, rest] = split(m_root, first);
+    const auto right = split(rest, last - first).m_right;
+    m_root = merge(left, right);
+    if (m_root != NIL) {
+        m_parent[m_root] = NIL;
+    }
+}
+
+std::size_t OrderIndex::at(std::size_t position) const noexcept
+{
+    auto node = m_root;
+    while (true) {
+        const auto left = count(m_left[node]);
+        if (position == left) {
+            return node;
+        }
+        if (position < left) {
+            node = m_left[node];
+        }
+        else {
+            position -= left + 1;
+            node = m_right[node];
+        }
+    }
+}
+
+std::size_t OrderIndex::position(const std::size_t id) const noexcept
+{
+    auto node = static_cast<std::uint32_t>(id);
+    auto result = count(m_left[node]);
+    for (auto parent = m_parent[node]; parent != NIL; node = parent, parent = m_parent[node]) {
+        if (m_right[parent] == node) {
+            result += count(m_left[parent]) + 1;
+        }
+    }
+    return result;
+}
+
+void OrderIndex::update(const std::uint32_t node) noexcept
+{
+    m_count[node] = static_cast<std::uint32_t>(1 + count(m_left[node]) + count(m_right[node]));
+}
+
+void OrderIndex::reserve(const std::size_t size)
+{
+    if (m_left.size() >= size) {
+        return;
+    }
+    const auto capacity = std::max(size, m_left.size() * 2);
+    for (auto * field : {&m_left, &m_right, &m_parent, &m_count, &m_priority}) {
+        field->resize(capacity);
+    }
+}
+
+std::uint32_t OrderIndex::priority() noexcept
+{
+    // xorshift64
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    return static_cast<std::uint32_t>(m_random >> 32);
+}
+
+OrderIndex::Split OrderIndex::split(const std::uint32_t node, const std::size_t count) noexcept
+{
+    if (node == NIL) {
+        return {NIL, NIL};
+    }
+    const auto left = this->count(m_left[node]);
+    if (count <= left) {
+        const auto [first, second] = split(m_left[node], count);
+        m_left[node] = second;
+        if (second != NIL) {
+            m_parent[second] = node;
+        }
+        update(node);
+        if (first != NIL) {
+            m_parent[first] = NIL;
+        }
+        m_parent[node] = NIL;
+        return {first, node};
+    }
+    const auto [first, second] = split(m_right[node], count - left - 1);
+    m_right[node] = first;
+    if (first != NIL) {
+        m_parent[first] = node;
+    }
+    update(node);
+    if (second != NIL) {
+        m_parent[second] = NIL;
+    }
+    m_parent[node] = NIL;
+    return {node, second};
+}
+
+std::uint32_t OrderIndex::merge(const std::uint32_t left, const std::uint32_t right) noexcept
+{
+    if (left == NIL) {
+        return right;
+    }
+    if (right == NIL) {
+        return left;
+    }
+    if (m_priority[left] > m_priority[right]) {
+        m_right[left] = merge(m_right[left], right);
+        m_parent[m_right[left]] = left;
+        update(left);
+        return left;
+    }
+    m_left[right] = merge(left, m_left[right]);
+    m_parent[m_left[right]] = right;
+    update(right);
+    return right;
+}
+
+} // namespace solution
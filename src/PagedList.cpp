@@ -0,0 +1,446 @@
+#include "PagedList.h"
+
+#include "ListStream.h"
+#include "Serializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace solution {
+
+namespace {
+
+/**
+ * Reads the whole range unless the file ends, the rest is zeroed.
+ */
+bool read_fully(const int fd, char * data, const std::size_t size, const off_t offset)
+{
+    std::size_t done = 0;
+    while (done < size) {
+        const auto count = ::pread(fd, data + done, size - done, offset + static_cast<off_t>(done));
+        if (count < 0) {
+            return false;
+        }
+        if (count == 0) {
+            std::fill(data + done, data + size, 0);
+            break;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool write_fully(const int fd, const char * data, const std::size_t size, const off_t offset)
+{
+    std::size_t done = 0;
+    while (done < size) {
+        const auto count = ::pwrite(fd, data + done, size - done, offset + static_cast<off_t>(done));
+        if (count <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+} // namespace
+
+PagedList::~PagedList()
+{
+    close();
+}
+
+int PagedList::open(const std::string & path, const std::size_t memory)
+{
+    if (memory < PAGE_SIZE) {
+        return -1;
+    }
+    close();
+    m_status = 0;
+    m_header = Header{};
+    const std::string paths[] = {path, path + ".payloads", path + ".positions"};
+    for (const auto file : {NODES, PAYLOADS, POSITIONS}) {
+        m_fds[file] = ::open(paths[file].c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_fds[file] < 0) {
+            close();
+            return 1;
+        }
+    }
+    Header header;
+    const auto count = ::pread(m_fds[NODES], &header, sizeof(header), 0);
+    if (count < 0) {
+        close();
+        return 1;
+    }
+    if (count > 0) {
+        if (static_cast<std::size_t>(count) != sizeof(header) || std::memcmp(header.m_magic, Header{}.m_magic, sizeof(header.m_magic)) != 0) {
+            close();
+            return 2;
+        }
+        m_header = header;
+    }
+    m_max_frames = memory / PAGE_SIZE;
+    m_lookup.reserve(m_max_frames);
+    return 0;
+}
+
+int PagedList::flush()
+{
+    if (m_fds[NODES] < 0) {
+        return -1;
+    }
+    for (auto & frame : m_frames) {
+        if (frame.m_dirty && !write_back(frame)) {
+            fail(1);
+        }
+    }
+    if (!write_fully(m_fds[NODES], reinterpret_cast<const char *>(&m_header), sizeof(m_header), 0)) {
+        fail(1);
+    }
+    return m_status;
+}
+
+int PagedList::close()
+{
+    auto status = 0;
+    if (m_fds[NODES] >= 0) {
+        status = flush();
+    }
+    for (auto & fd : m_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = -1;
+    }
+    drop_frames();
+    return status;
+}
+
+PagedList::Iterator PagedList::insert(const Iterator & position, const std::string_view data)
+{
+    const auto node = allocate();
+    Record record{};
+    record.m_next = position.m_node;
+    record.m_previous = position.m_node == NONE ? m_header.m_last : read(position.m_node).m_previous;
+    record.m_random = NONE;
+    record.m_payload = m_header.m_payload_size;
+    record.m_length = data.size();
+    write_payload(record.m_payload, data);
+    m_header.m_payload_size += data.size();
+    write(node, record);
+
+    if (record.m_previous == NONE) {
+        m_header.m_first = node;
+    }
+    else {
+        auto previous = read(record.m_previous);
+        previous.m_next = node;
+        write(record.m_previous, previous);
+    }
+    if (record.m_next == NONE) {
+        m_header.m_last = node;
+    }
+    else {
+        auto next = read(record.m_next);
+        next.m_previous = node;
+        write(record.m_next, next);
+    }
+    ++m_header.m_size;
+    m_header.m_numbered = 0;
+    return {this, node};
+}
+
+PagedList::Iterator PagedList::erase(const Iterator & position)
+{
+    auto record = read(position.m_node);
+    if (record.m_previous == NONE) {
+        m_header.m_first = record.m_next;
+    }
+    else {
+        auto previous = read(record.m_previous);
+        previous.m_next = record.m_next;
+        write(record.m_previous, previous);
+    }
+    if (record.m_next == NONE) {
+        m_header.m_last = record.m_previous;
+    }
+    else {
+        auto next = read(record.m_next);
+        next.m_previous = record.m_previous;
+        write(record.m_next, next);
+    }
+    const auto following = record.m_next;
+    record.m_next = m_header.m_free;
+    write(position.m_node, record);
+    m_header.m_free = position.m_node;
+    --m_header.m_size;
+    m_header.m_numbered = 0;
+    return {this, following};
+}
+
+void PagedList::link(const Iterator & position, const Iterator & random)
+{
+    auto record = read(position.m_node);
+    record.m_random = random.m_node;
+    write(position.m_node, record);
+}
+
+void PagedList::clear()
+{
+    drop_frames();
+    m_header = Header{};
+    for (const auto fd : m_fds) {
+        if (fd >= 0 && ::ftruncate(fd, 0) != 0) {
+            fail(1);
+        }
+    }
+}
+
+int PagedList::serialize(io::Sink & sink)
+{
+    if (m_fds[NODES] < 0) {
+        return -1;
+    }
+    // Positions are kept in their own file, so no memory proportional to the list is needed
+    // and the pages of nodes stay clean. They are current until the list is changed
+    if (!m_header.m_numbered) {
+        std::uint64_t position = 0;
+        for (auto node = m_header.m_first; node != NONE; node = read(node).m_next) {
+            write_position(node, position++);
+        } // O(n)
+        m_header.m_numbered = m_status == 0;
+    }
+    format::Writer writer(sink);
+    std::string data;
+    for (auto node = m_header.m_first; node != NONE && m_status == 0;) {
+        const auto record = read(node);
+        read_payload(record.m_payload, record.m_length, data);
+        writer.write(data.data(), data.size());
+        writer.write("", 1);
+        const auto random = record.m_random == NONE ? ListStream::NO_RANDOM : read_position(record.m_random);
+        serializers::Serializer<std::uint64_t>::serialize(random, writer);
+        node = record.m_next;
+    } // O(n)
+    if (!writer.flush()) {
+        return 1;
+    }
+    return m_status;
+}
+
+int PagedList::deserialize(io::Source & source)
+{
+    if (m_fds[NODES] < 0) {
+        return -1;
+    }
+    clear();
+    ListStream stream;
+    auto status = stream.open(source);
+    if (status == 0) {
+        // Nodes of an empty list are numbered by their positions, so indexes are stored as they are
+        status = stream.for_each([this](const std::string_view data, const std::uint64_t random) {
+            append(data, random == ListStream::NO_RANDOM ? NONE : random);
+        });
+    }
+    for (auto node = m_header.m_first; status == 0 && node != NONE;) {
+        const auto record = read(node);
+        if (record.m_random != NONE && record.m_random >= m_header.m_size) {
+            status = 1;
+        }
+        node = record.m_next;
+    } // O(n)
+    if (status == 0) {
+        status = m_status;
+    }
+    if (status != 0) {
+        clear();
+    }
+    return status;
+}
+
+char * PagedList::page(const File file, const std::uint64_t number, const bool write)
+{
+    const auto key = number * FILES + file;
+    const auto found = m_lookup.find(key);
+    auto index = found == m_lookup.end() ? NO_FRAME : found->second;
+    if (index == NO_FRAME) {
+        if (m_frames.size() < m_max_frames) {
+            index = static_cast<std::uint32_t>(m_frames.size());
+            m_frames.emplace_back();
+            m_frames.back().m_bytes = std::make_unique<char[]>(PAGE_SIZE);
+        }
+        else {
+            index = m_oldest;
+            auto & victim = m_frames[index];
+            if (victim.m_dirty && !write_back(victim)) {
+                fail(1);
+            }
+            m_lookup.erase(victim.m_key);
+            unlink_frame(index);
+        }
+        auto & frame = m_frames[index];
+        if (!read_fully(m_fds[file], frame.m_bytes.get(), PAGE_SIZE, static_cast<off_t>(number * PAGE_SIZE))) {
+            fail(1);
+        }
+        frame.m_key = key;
+        frame.m_dirty = false;
+        m_lookup.emplace(key, index);
+        push_frame(index);
+    }
+    else if (index != m_newest) {
+        unlink_frame(index);
+        push_frame(index);
+    }
+    auto & frame = m_frames[index];
+    frame.m_dirty = frame.m_dirty || write;
+    return frame.m_bytes.get();
+}
+
+bool PagedList::write_back(Frame & frame)
+{
+    const auto file = frame.m_key % FILES;
+    const auto number = frame.m_key / FILES;
+    frame.m_dirty = false;
+    return write_fully(m_fds[file], frame.m_bytes.get(), PAGE_SIZE, static_cast<off_t>(number * PAGE_SIZE));
+}
+
+void PagedList::unlink_frame(const std::uint32_t index) noexcept
+{
+    auto & frame = m_frames[index];
+    if (frame.m_previous == NO_FRAME) {
+        m_newest = frame.m_next;
+    }
+    else {
+        m_frames[frame.m_previous].m_next = frame.m_next;
+    }
+    if (frame.m_next == NO_FRAME) {
+        m_oldest = frame.m_previous;
+    }
+    else {
+        m_frames[frame.m_next].m_previous = frame.m_previous;
+    }
+    frame.m_previous = frame.m_next = NO_FRAME;
+}
+
+void PagedList::push_frame(const std::uint32_t index) noexcept
+{
+    auto & frame = m_frames[index];
+    frame.m_previous = NO_FRAME;
+    frame.m_next = m_newest;
+    if (m_newest != NO_FRAME) {
+        m_frames[m_newest].m_previous = index;
+    }
+    m_newest = index;
+    if (m_oldest == NO_FRAME) {
+        m_oldest = index;
+    }
+}
+
+void PagedList::drop_frames() noexcept
+{
+    m_frames.clear();
+    m_lookup.clear();
+    m_newest = m_oldest = NO_FRAME;
+}
+
+PagedList::Record PagedList::read(const std::uint64_t node)
+{
+    Record record;
+    // The first page of the file of nodes is the header
+    const auto * bytes = page(NODES, 1 + node / RECORDS_PER_PAGE, false);
+    std::memcpy(&record, bytes + node % RECORDS_PER_PAGE * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+void PagedList::write(const std::uint64_t node, const Record & record)
+{
+    auto * bytes = page(NODES, 1 + node / RECORDS_PER_PAGE, true);
+    std::memcpy(bytes + node % RECORDS_PER_PAGE * sizeof(Record), &record, sizeof(Record));
+}
+
+void PagedList::read_payload(std::uint64_t offset, const std::size_t length, std::string & data)
+{
+    data.resize(length);
+    for (std::size_t done = 0; done < length;) {
+        const auto within = offset % PAGE_SIZE;
+        const auto count = std::min(length - done, PAGE_SIZE - within);
+        std::memcpy(&data[done], page(PAYLOADS, offset / PAGE_SIZE, false) + within, count);
+        done += count;
+        offset += count;
+    }
+}
+
+void PagedList::write_payload(std::uint64_t offset, const std::string_view data)
+{
+    for (std::size_t done = 0; done < data.size();) {
+        const auto within = offset % PAGE_SIZE;
+        const auto count = std::min(data.size() - done, PAGE_SIZE - within);
+        std::memcpy(page(PAYLOADS, offset / PAGE_SIZE, true) + within, data.data() + done, count);
+        done += count;
+        offset += count;
+    }
+}
+
+std::uint64_t PagedList::read_position(const std::uint64_t node)
+{
+    std::uint64_t position;
+    const auto * bytes = page(POSITIONS, node / POSITIONS_PER_PAGE, false);
+    std::memcpy(&position, bytes + node % POSITIONS_PER_PAGE * sizeof(position), sizeof(position));
+    return position;
+}
+
+void PagedList::write_position(const std::uint64_t node, const std::uint64_t position)
+{
+    auto * bytes = page(POSITIONS, node / POSITIONS_PER_PAGE, true);
+    std::memcpy(bytes + node % POSITIONS_PER_PAGE * sizeof(position), &position, sizeof(position));
+}
+
+std::uint64_t PagedList::allocate()
+{
+    if (m_header.m_free == NONE) {
+        return m_header.m_nodes++;
+    }
+    const auto node = m_header.m_free;
+    m_header.m_free = read(node).m_next;
+    return node;
+}
+
+std::uint64_t PagedList::append(const std::string_view data, const std::uint64_t random)
+{
+    const auto node = insert(end(), data).m_node;
+    auto record = read(node);
+    record.m_random = random;
+    write(node, record);
+    return node;
+}
+
+const std::string & PagedList::Iterator::operator*() const
+{
+    if (!m_loaded) {
+        const auto record = m_list->read(m_node);
+        m_list->read_payload(record.m_payload, record.m_length, m_data);
+        m_loaded = true;
+    }
+    return m_data;
+}
+
+PagedList::Iterator & PagedList::Iterator::operator++()
+{
+    reset(m_list->read(m_node).m_next);
+    return *this;
+}
+
+PagedList::Iterator & PagedList::Iterator::operator--()
+{
+    reset(m_node == NONE ? m_list->m_header.m_last : m_list->read(m_node).m_previous);
+    return *this;
+}
+
+PagedList::Iterator & PagedList::Iterator::move()
+{
+    reset(m_list->read(m_node).m_random);
+    return *this;
+}
+
+} // namespace solution
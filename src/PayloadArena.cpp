@@ -0,0 +1,76 @@
+#include "PayloadArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace solution {
+
+std::string_view PayloadArena::store(const std::string_view data)
+{
+    if (data.empty()) {
+        return {};
+    }
+    auto * bytes = allocate(data.size());
+    std::memcpy(bytes, data.data(), data.size());
+    return {bytes, data.size()};
+}
+
+char * PayloadArena::allocate(const std::size_t size)
+{
+    m_size += size;
+    if (size > m_available && size > SLAB_SIZE / 4) {
+        // The current slab is kept: it is likely to have room for the following payloads.
+        m_slabs.emplace_back(new char[size]);
+        return m_slabs.back().get();
+    }
+    if (size > m_available) {
+        m_slabs.emplace_back(new char[SLAB_SIZE]);
+        m_cursor = m_slabs.back().get();
+        m_available = SLAB_SIZE;
+    }
+    auto * bytes = m_cursor;
+    m_cursor += size;
+    m_available -= size;
+    return bytes;
+}
+
+void PayloadArena::adopt(std::shared_ptr<char[]> bytes, const std::size_t size)
+{
+    m_slabs.push_back(std::move(bytes));
+    m_size += size;
+}
+
+void PayloadArena::merge(PayloadArena && other)
+{
+    if (&other == this) {
+        return;
+    }
+    // The current slab is kept, the slabs of other are only owned
+    m_slabs.insert(m_slabs.begin(), std::make_move_iterator(other.m_slabs.begin()), std::make_move_iterator(other.m_slabs.end()));
+    m_size += other.m_size;
+    m_garbage += other.m_garbage;
+    m_discarded += other.m_discarded;
+    other.release();
+}
+
+void PayloadArena::reserve(const std::size_t size)
+{
+    if (size > m_available) {
+        m_slabs.emplace_back(new char[std::max(size, SLAB_SIZE)]);
+        m_cursor = m_slabs.back().get();
+        m_available = std::max(size, SLAB_SIZE);
+    }
+}
+
+void PayloadArena::release() noexcept
+{
+    m_slabs.clear();
+    m_cursor = nullptr;
+    m_available = 0;
+    m_size = 0;
+    m_garbage = 0;
+    m_discarded = 0;
+}
+
+} // namespace solution
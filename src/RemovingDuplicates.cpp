@@ -1,15 +1,616 @@
 #include "RemovingDuplicates.h"
 
+#include "Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace solution {
 
+namespace {
+
+/**
+ * Chunks of remove_duplicates_parallel() are not made smaller, so that
+ * handing out a chunk is negligible.
+ */
+constexpr std::size_t MIN_CHUNK = 1 << 20;
+
+/**
+ * Streams are handled by blocks that fit into caches of processors,
+ * files are mapped by larger windows to keep the number of system calls low.
+ */
+constexpr std::size_t STREAM_BLOCK = 1 << 20;
+constexpr std::size_t STREAM_WINDOW = 64 << 20;
+
+/**
+ * Strings of a batch are grouped into tasks of about this many bytes,
+ * every string counts as STRING_COST bytes more for the call and the cache miss.
+ */
+constexpr std::size_t BATCH_TASK = 64 << 10;
+constexpr std::size_t STRING_COST = 64;
+constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+// Every kernel has two variants: the string is either terminated by the null
+// character (end is not used) or BOUNDED by end and may contain null characters.
+// The result is written to out, which is either str or does not overlap the
+// rest of the string, both variants return the new length.
+
+/**
+ * Handles the character at in: keeps it if it differs from the previous one,
+ * which is equal to the last kept one. The character is written after the
+ * last kept one in any case, so there is no branch to mispredict.
+ *
+ * @return false if the string has ended.
+ */
+template <bool BOUNDED>
+inline bool step(char *& last, char & previous, const char * in, const char * end)
+{
+    if constexpr (BOUNDED) {
+        if (in == end) {
+            return false;
+        }
+    }
+    const auto c = *in;
+    *(last + 1) = c;
+    last += c != previous ? 1 : 0;
+    previous = c;
+    return BOUNDED || c != '\0';
+}
+
+/**
+ * Handles the characters up to the first address aligned to width.
+ * The first character is always kept, last points to the last kept one
+ * and in points to the character to handle next.
+ *
+ * @return false if the string has ended.
+ */
+template <bool BOUNDED>
+inline bool align(const char * str, const char * end, char * out, const std::size_t width, char *& last, const char *& in)
+{
+    last = out;
+    in = str;
+    if (BOUNDED && str == end) {
+        return false;
+    }
+    auto previous = *str;
+    *out = previous;
+    if (!BOUNDED && previous == '\0') {
+        return false;
+    }
+    for (++in; reinterpret_cast<std::uintptr_t>(in) % width != 0; ++in) {
+        if (!step<BOUNDED>(last, previous, in, end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Handles the rest of the string byte by byte.
+ *
+ * @param running false if align() has reached the end.
+ * @return the new length.
+ */
+template <bool BOUNDED>
+inline std::size_t finish(const char * str, const char * end, char * out, char * last, const char * in, const bool running)
+{
+    if (BOUNDED ? str == end : *str == '\0') {
+        return 0;
+    }
+    if (running) {
+        auto previous = *last;
+        while (step<BOUNDED>(last, previous, in, end)) {
+            ++in;
+        }
+    }
+    // A null terminated string keeps its terminating null character
+    return static_cast<std::size_t>(last - out) + (BOUNDED ? 1 : 0);
+}
+
+template <bool BOUNDED>
+std::size_t remove_portable(const char * str, const char * end, char * out)
+{
+    char * last;
+    const char * in;
+    const auto running = align<BOUNDED>(str, end, out, 1, last, in);
+    return finish<BOUNDED>(str, end, out, last, in, running);
+}
+
+/**
+ * Positions of the set bits of every 8-bit mask, for byte shuffles.
+ */
+using Shuffles = std::array<std::array<std::uint8_t, 8>, 256>;
+
+constexpr Shuffles make_shuffles()
+{
+    Shuffles shuffles{};
+    for (std::size_t mask = 0; mask < 256; ++mask) {
+        std::size_t count = 0;
+        for (std::uint8_t bit = 0; bit < 8; ++bit) {
+            if (mask >> bit & 1) {
+                shuffles[mask][count++] = bit;
+            }
+        }
+        for (; count < 8; ++count) {
+            shuffles[mask][count] = 0x80;
+        }
+    }
+    return shuffles;
+}
+
+[[maybe_unused]] constexpr Shuffles SHUFFLES = make_shuffles();
+
+#if defined(__x86_64__)
+
+/**
+ * Writes the bytes of the half of block (the bytes 8 * half ... 8 * half + 7) that are selected by mask after last.
+ */
+__attribute__((target("ssse3"))) inline char * compact_half(char * last, __m128i block, unsigned mask, int half)
+{
+    auto shuffle = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(SHUFFLES[mask].data()));
+    if (half) {
+        shuffle = _mm_add_epi8(shuffle, _mm_set1_epi8(8));
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(last + 1), _mm_shuffle_epi8(block, shuffle));
+    return last + __builtin_popcount(mask);
+}
+
+// Blocks are loaded from aligned addresses, so a load does not cross a page boundary.
+// Bounded strings are never read past end, other threads may own the following bytes.
+// The last kept character is equal to the previous one, so it starts the shifted block.
+
+template <bool BOUNDED>
+__attribute__((target("ssse3"))) std::size_t remove_ssse3(const char * str, const char * end, char * out)
+{
+    char * last;
+    const char * in;
+    const auto running = align<BOUNDED>(str, end, out, 16, last, in);
+    if (running) {
+        auto previous = _mm_set1_epi8(*last);
+        for (;; in += 16) {
+            if constexpr (BOUNDED) {
+                if (end - in < 16) {
+                    break;
+                }
+            }
+            const auto block = _mm_load_si128(reinterpret_cast<const __m128i *>(in));
+            if constexpr (!BOUNDED) {
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())) != 0) {
+                    break;
+                }
+            }
+            const auto shifted = _mm_alignr_epi8(block, previous, 15);
+            previous = block;
+            const auto keep = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, shifted))) & 0xffff;
+            if (keep == 0xffff) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(last + 1), block);
+                last += 16;
+                continue;
+            }
+            last = compact_half(last, block, keep & 0xff, 0);
+            last = compact_half(last, block, keep >> 8, 1);
+        }
+    }
+    return finish<BOUNDED>(str, end, out, last, in, running);
+}
+
+template <bool BOUNDED>
+__attribute__((target("avx2"))) std::size_t remove_avx2(const char * str, const char * end, char * out)
+{
+    char * last;
+    const char * in;
+    const auto running = align<BOUNDED>(str, end, out, 32, last, in);
+    if (running) {
+        auto previous = _mm256_set1_epi8(*last);
+        for (;; in += 32) {
+            if constexpr (BOUNDED) {
+                if (end - in < 32) {
+                    break;
+                }
+            }
+            const auto block = _mm256_load_si256(reinterpret_cast<const __m256i *>(in));
+            if constexpr (!BOUNDED) {
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_setzero_si256())) != 0) {
+                    break;
+                }
+            }
+            // The upper half of previous and the lower half of block, alignr shifts within 128-bit lanes
+            const auto middle = _mm256_permute2x128_si256(previous, block, 0x21);
+            const auto shifted = _mm256_alignr_epi8(block, middle, 15);
+            previous = block;
+            const auto keep = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, shifted)));
+            if (keep == 0xffffffff) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(last + 1), block);
+                last += 32;
+                continue;
+            }
+            const auto low = _mm256_castsi256_si128(block);
+            const auto high = _mm256_extracti128_si256(block, 1);
+            last = compact_half(last, low, keep & 0xff, 0);
+            last = compact_half(last, low, keep >> 8 & 0xff, 1);
+            last = compact_half(last, high, keep >> 16 & 0xff, 0);
+            last = compact_half(last, high, keep >> 24, 1);
+        }
+    }
+    return finish<BOUNDED>(str, end, out, last, in, running);
+}
+
+template <bool BOUNDED>
+__attribute__((target("avx512f,avx512bw,avx512vbmi,avx512vbmi2"))) std::size_t remove_avx512(const char * str, const char * end, char * out)
+{
+    char * last;
+    const char * in;
+    const auto running = align<BOUNDED>(str, end, out, 64, last, in);
+    if (running) {
+        // The index i - 1 for every byte i, the byte 0 takes the last byte of the previous block
+        alignas(64) std::uint8_t indexes[64];
+        indexes[0] = 127;
+        for (std::uint8_t i = 1; i < 64; ++i) {
+            indexes[i] = static_cast<std::uint8_t>(i - 1);
+        }
+        const auto shift = _mm512_load_si512(indexes);
+        auto previous = _mm512_set1_epi8(*last);
+        for (;; in += 64) {
+            if constexpr (BOUNDED) {
+                if (end - in < 64) {
+                    break;
+                }
+            }
+            const auto block = _mm512_load_si512(in);
+            if constexpr (!BOUNDED) {
+                if (_mm512_cmpeq_epi8_mask(block, _mm512_setzero_si512()) != 0) {
+                    break;
+                }
+            }
+            const auto shifted = _mm512_permutex2var_epi8(block, shift, previous);
+            previous = block;
+            const auto keep = _mm512_cmpneq_epi8_mask(block, shifted);
+            _mm512_storeu_si512(last + 1, _mm512_maskz_compress_epi8(keep, block));
+            last += __builtin_popcountll(keep);
+        }
+    }
+    return finish<BOUNDED>(str, end, out, last, in, running);
+}
+
+bool supported(const DuplicatesKernel kernel)
+{
+    switch (kernel) {
+    case DuplicatesKernel::PORTABLE:
+        return true;
+    case DuplicatesKernel::SSSE3:
+        return __builtin_cpu_supports("ssse3");
+    case DuplicatesKernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case DuplicatesKernel::AVX512:
+        return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi") && __builtin_cpu_supports("avx512vbmi2");
+    default:
+        return false;
+    }
+}
+
+#elif defined(__aarch64__)
+
+inline char * compact_half(char * last, uint8x8_t half, unsigned mask)
+{
+    const auto shuffle = vld1_u8(SHUFFLES[mask].data());
+    vst1_u8(reinterpret_cast<std::uint8_t *>(last + 1), vtbl1_u8(half, shuffle));
+    return last + __builtin_popcount(mask);
+}
+
+template <bool BOUNDED>
+std::size_t remove_neon(const char * str, const char * end, char * out)
+{
+    char * last;
+    const char * in;
+    const auto running = align<BOUNDED>(str, end, out, 16, last, in);
+    if (running) {
+        const std::uint8_t bits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+        const auto weights = vld1_u8(bits);
+        auto previous = vdupq_n_u8(static_cast<std::uint8_t>(*last));
+        for (;; in += 16) {
+            if constexpr (BOUNDED) {
+                if (end - in < 16) {
+                    break;
+                }
+            }
+            const auto block = vld1q_u8(reinterpret_cast<const std::uint8_t *>(in));
+            if constexpr (!BOUNDED) {
+                if (vmaxvq_u8(vceqzq_u8(block)) != 0) {
+                    break;
+                }
+            }
+            const auto shifted = vextq_u8(previous, block, 15);
+            previous = block;
+            // There is no movemask, the bits of the mask are summed up
+            const auto differ = vmvnq_u8(vceqq_u8(block, shifted));
+            const unsigned low = vaddv_u8(vand_u8(vget_low_u8(differ), weights));
+            const unsigned high = vaddv_u8(vand_u8(vget_high_u8(differ), weights));
+            if ((low & high) == 0xff) {
+                vst1q_u8(reinterpret_cast<std::uint8_t *>(last + 1), block);
+                last += 16;
+                continue;
+            }
+            last = compact_half(last, vget_low_u8(block), low);
+            last = compact_half(last, vget_high_u8(block), high);
+        }
+    }
+    return finish<BOUNDED>(str, end, out, last, in, running);
+}
+
+bool supported(const DuplicatesKernel kernel)
+{
+    // Advanced SIMD is a mandatory part of AArch64
+    return kernel == DuplicatesKernel::PORTABLE || kernel == DuplicatesKernel::NEON;
+}
+
+#else
+
+bool supported(const DuplicatesKernel kernel)
+{
+    return kernel == DuplicatesKernel::PORTABLE;
+}
+
+#endif
+
+using Remove = std::size_t (*)(const char *, const char *, char *);
+
+template <bool BOUNDED>
+Remove implementation(const DuplicatesKernel kernel)
+{
+    switch (kernel) {
+#if defined(__x86_64__)
+    case DuplicatesKernel::SSSE3:
+        return remove_ssse3<BOUNDED>;
+    case DuplicatesKernel::AVX2:
+        return remove_avx2<BOUNDED>;
+    case DuplicatesKernel::AVX512:
+        return remove_avx512<BOUNDED>;
+#elif defined(__aarch64__)
+    case DuplicatesKernel::NEON:
+        return remove_neon<BOUNDED>;
+#endif
+    default:
+        return remove_portable<BOUNDED>;
+    }
+}
+
+DuplicatesKernel select()
+{
+    static const auto kernel = [] {
+        for (const auto candidate : {DuplicatesKernel::AVX512, DuplicatesKernel::AVX2, DuplicatesKernel::NEON, DuplicatesKernel::SSSE3}) {
+            if (supported(candidate)) {
+                return candidate;
+            }
+        }
+        return DuplicatesKernel::PORTABLE;
+    }();
+    return kernel;
+}
+
+/**
+ * @return bounds of the tasks of a batch, the task i handles the strings bounds[i] ... bounds[i + 1] - 1.
+ */
+template <typename Length>
+std::vector<std::size_t> group(const std::size_t count, Length && length)
+{
+    std::vector<std::size_t> bounds{0};
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        bytes += length(i) + STRING_COST;
+        if (bytes >= BATCH_TASK) {
+            bounds.push_back(i + 1);
+            bytes = 0;
+        }
+    }
+    if (bounds.back() != count) {
+        bounds.push_back(count);
+    }
+    return bounds;
+}
+
+} // namespace
+
 void remove_duplicates(char * str)
 {
-    auto * last = str;
-    while (*(str++) != '\0') {
-        if (*str != *last) {
-            *(++last) = *str;
+    static const auto remove = implementation<false>(select());
+    remove(str, nullptr, str);
+}
+
+bool remove_duplicates(char * str, const DuplicatesKernel kernel)
+{
+    if (!supported(kernel)) {
+        return false;
+    }
+    implementation<false>(kernel)(str, nullptr, str);
+    return true;
+}
+
+DuplicatesKernel remove_duplicates_kernel()
+{
+    return select();
+}
+
+std::size_t remove_duplicates(char * data, const std::size_t length)
+{
+    return remove_duplicates(data, length, data);
+}
+
+std::size_t remove_duplicates(const char * data, const std::size_t length, char * out)
+{
+    static const auto remove = implementation<true>(select());
+    return remove(data, data + length, out);
+}
+
+bool remove_duplicates(char * data, std::size_t & length, const DuplicatesKernel kernel)
+{
+    if (!supported(kernel)) {
+        return false;
+    }
+    length = implementation<true>(kernel)(data, data + length, data);
+    return true;
+}
+std::size_t remove_duplicates_parallel(char * data, const std::size_t length, const std::size_t threads)
+{
+    const auto count = std::min(resolve_threads(threads) * 4, std::max<std::size_t>(length / MIN_CHUNK, 1));
+    if (count == 1) {
+        return remove_duplicates(data, length);
+    }
+    // Chunks are longer than their number, so none of them is empty
+    const auto chunk = (length + count - 1) / count;
+    // A run that crosses a boundary stays in the left chunk, so the first byte
+    // of the right one is dropped. Boundaries are compared before chunks change.
+    std::vector<std::size_t> dropped(count, 0);
+    for (std::size_t i = 1; i < count; ++i) {
+        dropped[i] = data[i * chunk - 1] == data[i * chunk] ? 1 : 0;
+    }
+    std::vector<std::size_t> lengths(count);
+    parallel_for(count, threads, [&](const std::size_t i) {
+        const auto begin = i * chunk;
+        lengths[i] = remove_duplicates(data + begin, std::min(begin + chunk, length) - begin);
+    });
+    // Chunks only move to the left, so they are moved in order
+    auto size = lengths[0];
+    for (std::size_t i = 1; i < count; ++i) {
+        const auto kept = lengths[i] - dropped[i];
+        std::memmove(data + size, data + i * chunk + dropped[i], kept);
+        size += kept;
+    }
+    return size;
+}
+
+std::string_view DuplicatesFilter::filter(const char * data, const std::size_t length, char * out)
+{
+    const auto size = remove_duplicates(data, length, out);
+    if (size == 0) {
+        return {};
+    }
+    // The run that continues the previous block has been written already
+    const auto skip = m_started && *out == m_last ? 1 : 0;
+    m_started = true;
+    m_last = out[size - 1];
+    return {out + skip, size - skip};
+}
+
+int remove_duplicates(io::Source & source, io::Sink & sink)
+{
+    std::vector<char> buffer(STREAM_BLOCK);
+    DuplicatesFilter filter;
+    for (;;) {
+        const auto count = source.read(buffer.data(), buffer.size());
+        if (count == 0) {
+            break;
+        }
+        const auto result = filter.filter(buffer.data(), count, buffer.data());
+        if (!sink.write(result.data(), result.size())) {
+            return 1;
+        }
+    }
+    return sink.flush() ? 0 : 1;
+}
+
+int remove_duplicates(file_ptr_t input, file_ptr_t output)
+{
+    if (!input || !output) {
+        return -1;
+    }
+    io::FileSource source(input);
+    io::FileSink sink(output);
+    return remove_duplicates(source, sink);
+}
+
+int remove_duplicates(const int input, io::Sink & sink)
+{
+    if (input < 0) {
+        return -1;
+    }
+    struct stat status;
+    const auto position = ::lseek(input, 0, SEEK_CUR);
+    if (fstat(input, &status) != 0) {
+        return 1;
+    }
+    if (!S_ISREG(status.st_mode) || position < 0) {
+        io::FdSource source(input);
+        return remove_duplicates(source, sink);
+    }
+    // Windows are mapped from offsets aligned to pages, the output of a block goes to a small buffer
+    const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    const auto size = static_cast<std::uint64_t>(status.st_size);
+    std::vector<char> buffer(STREAM_BLOCK);
+    DuplicatesFilter filter;
+    for (auto offset = static_cast<std::uint64_t>(position); offset < size;) {
+        const auto base = offset / page * page;
+        const auto length = std::min<std::uint64_t>(STREAM_WINDOW, size - base);
+        auto * mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, input, static_cast<off_t>(base));
+        if (mapping == MAP_FAILED) {
+            return 1;
         }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        const auto * window = static_cast<const char *>(mapping);
+        auto result = true;
+        for (auto * data = window + (offset - base); result && data != window + length;) {
+            const auto count = std::min<std::size_t>(STREAM_BLOCK, static_cast<std::size_t>(window + length - data));
+            const auto block = filter.filter(data, count, buffer.data());
+            result = sink.write(block.data(), block.size());
+            data += count;
+        }
+        munmap(mapping, length);
+        if (!result) {
+            return 1;
+        }
+        offset = base + length;
     }
+    // The descriptor is left at the end as if the file was read
+    ::lseek(input, static_cast<off_t>(size), SEEK_SET);
+    return sink.flush() ? 0 : 1;
+}
+
+int remove_duplicates(const int input, const int output)
+{
+    if (output < 0) {
+        return -1;
+    }
+    io::FdSink sink(output);
+    return remove_duplicates(input, sink);
+}
+
+void remove_duplicates_batch(char * const * strings, std::size_t * lengths, const std::size_t count, const std::size_t threads)
+{
+    const auto bounds = group(count, [lengths](const std::size_t i) { return lengths[i]; });
+    parallel_for(bounds.size() - 1, threads, [&](const std::size_t task) {
+        const auto remove = implementation<true>(select());
+        for (auto i = bounds[task]; i < bounds[task + 1]; ++i) {
+            // Strings of a batch are usually scattered over the heap
+            if (i + PREFETCH_DISTANCE < bounds[task + 1]) {
+                __builtin_prefetch(strings[i + PREFETCH_DISTANCE], 1);
+            }
+            lengths[i] = remove(strings[i], strings[i] + lengths[i], strings[i]);
+        }
+    });
+}
+
+void remove_duplicates_batch(char * buffer, const std::size_t * offsets, const std::size_t count, std::size_t * lengths, const std::size_t threads)
+{
+    const auto bounds = group(count, [offsets](const std::size_t i) { return offsets[i + 1] - offsets[i]; });
+    parallel_for(bounds.size() - 1, threads, [&](const std::size_t task) {
+        const auto remove = implementation<true>(select());
+        for (auto i = bounds[task]; i < bounds[task + 1]; ++i) {
+            auto * str = buffer + offsets[i];
+            lengths[i] = remove(str, buffer + offsets[i + 1], str);
+        }
+    });
 }
 
 } // namespace solution
@@ -1,23 +1,118 @@
 #include "Serialization.h"
 
-#include <optional>
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace solution {
 
-List::List()
+List::BasicList()
     : m_head(&m_tail)
     , m_size(0)
 {
 }
 
+List::~BasicList()
+{
+    clear();
+}
+
+List::BasicList(BasicList && other) noexcept
+    : BasicList()
+{
+    *this = std::move(other);
+}
+
+List & List::operator=(BasicList && other) noexcept
+{
+    if (this != &other) {
+        // The journal and the index of this list describe the old elements
+        m_journal.reset();
+        m_index.reset();
+        take(other);
+        m_index = std::move(other.m_index);
+    }
+    return *this;
+}
+
+void List::splice(ConstIterator position, List & other)
+{
+    if (&other == this || other.empty()) {
+        return;
+    }
+    auto * next = resolve(position);
+    other.thaw();
+    if (m_journal || other.m_journal) {
+        std::vector<const ListNode *> nodes;
+        nodes.reserve(other.m_size);
+        for (const auto * node = other.m_head; node != &other.m_tail; node = node->m_next) {
+            nodes.push_back(node);
+        }
+        std::vector<std::size_t> positions(other.m_pool.capacity());
+        std::vector<ConstIterator> copies;
+        copies.reserve(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            positions[other.m_pool.slot(nodes[i])] = i;
+            copies.push_back(insert(ConstIterator{this, next}, nodes[i]->m_data));
+        }
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (const auto * random = nodes[i]->m_random) {
+                link(copies[i], copies[positions[other.m_pool.slot(random)]]);
+            }
+        } // O(k log(number of slabs))
+        other.clear();
+        return;
+    }
+
+    auto * first = other.m_head;
+    auto * last = other.m_tail.m_previous;
+    m_pool.merge(std::move(other.m_pool));
+    m_arena.merge(std::move(other.m_arena));
+    first->m_previous = next->m_previous;
+    if (next->m_previous) {
+        next->m_previous->m_next = first;
+    }
+    else {
+        m_head = first;
+    }
+    last->m_next = next;
+    next->m_previous = last;
+    m_size += other.m_size;
+
+    other.m_head = &other.m_tail;
+    other.m_tail.m_previous = nullptr;
+    other.m_size = 0;
+    if (other.m_index) {
+        other.m_index->clear();
+    }
+    // Slots of the nodes of other are renumbered
+    reindex();
+}
+
 List::Iterator List::insert(ConstIterator position, const std::string_view data)
 {
-    auto * node = position.m_pointer;
-    auto * inserted = new ListNode();
-    inserted->m_data = data;
+    auto * next = resolve(position);
+    auto * inserted = link_before(next, m_arena.store(data));
+    if (m_journal) {
+        record(format::Change::INSERT, {next == &m_tail ? 0 : id(next) + 1}, data);
+        identify(inserted);
+    }
+    return Iterator{this, inserted};
+}
+
+List::ListNode * List::link_before(ListNode * node, const std::string_view stored)
+{
+    auto * inserted = m_pool.create();
+    inserted->m_data = stored;
 
+    if (m_index) {
+        const auto position = node == &m_tail ? m_size : m_index->position(m_pool.slot(node));
+        m_index->insert(position, m_pool.slot(inserted));
+    }
     inserted->m_next = node;
     inserted->m_previous = node->m_previous;
 
@@ -31,7 +126,7 @@ List::Iterator List::insert(ConstIterator position, const std::string_view data)
 
     ++m_size;
 
-    return Iterator{&m_tail, inserted};
+    return inserted;
 }
 
 List::Iterator List::push_front(std::string_view data)
@@ -44,9 +139,41 @@ List::Iterator List::push_back(std::string_view data)
     return insert(end(), data);
 }
 
+List::Iterator List::assign(ConstIterator position, const std::string_view data)
+{
+    auto * node = resolve(position);
+    const auto previous = std::exchange(node->m_data, m_arena.store(data));
+    if (m_journal) {
+        record(format::Change::ASSIGN, {id(node)}, data);
+    }
+    discard(previous);
+    return Iterator{this, node};
+}
+
 List::Iterator List::erase(ConstIterator position)
 {
-    auto * node = position.m_pointer;
+    auto * node = resolve(position);
+    if (m_index) {
+        m_index->erase(m_pool.slot(node));
+    }
+    return Iterator{this, unlink(node)};
+}
+
+List::Iterator List::erase(ConstIterator first, ConstIterator last)
+{
+    auto * node = resolve(first);
+    auto * stop = resolve(last);
+    if (m_index && node != stop) {
+        m_index->erase(m_index->position(m_pool.slot(node)), stop == &m_tail ? m_size : m_index->position(m_pool.slot(stop)));
+    }
+    while (node != stop) {
+        node = unlink(node);
+    }
+    return Iterator{this, stop};
+}
+
+List::ListNode * List::unlink(ListNode * node)
+{
     auto * next = node->m_next;
     auto * previous = node->m_previous;
     if (next) {
@@ -58,9 +185,36 @@ List::Iterator List::erase(ConstIterator position)
     else {
         m_head = next;
     }
-    delete node;
+    if (m_journal) {
+        record(format::Change::ERASE, {id(node)});
+    }
+    const auto data = node->m_data;
+    m_pool.destroy(node);
     --m_size;
-    return Iterator{&m_tail, next};
+    discard(data);
+    return next;
+}
+
+void List::discard(const std::string_view data)
+{
+    m_arena.discard(data);
+    if (!m_arena.wasteful(m_size)) {
+        return;
+    }
+    // Nodes stay in place, views of a shared dictionary entry keep sharing a copy
+    std::unordered_map<const char *, std::string_view> copies;
+    PayloadArena arena;
+    for (auto * node = m_head; node != &m_tail; node = node->m_next) {
+        if (node->m_data.empty()) {
+            continue;
+        }
+        auto & copy = copies[node->m_data.data()];
+        if (copy.size() != node->m_data.size()) {
+            copy = arena.store(node->m_data);
+        }
+        node->m_data = copy;
+    } // O(n + total size of payloads) on average
+    m_arena = std::move(arena);
 }
 
 List::Iterator List::pop_front()
@@ -75,138 +229,921 @@ List::Iterator List::pop_back()
 
 List::Iterator List::begin() noexcept
 {
-    return Iterator{&m_tail, m_head};
+    return m_frozen ? Iterator{this, std::size_t{0}} : Iterator{this, m_head};
 }
 
 List::ConstIterator List::begin() const noexcept
 {
-    return ConstIterator{&m_tail, m_head};
+    return const_cast<List *>(this)->begin();
 }
 
 List::Iterator List::end() noexcept
 {
-    return Iterator{&m_tail, &m_tail};
+    return m_frozen ? Iterator{this, m_size} : Iterator{this, &m_tail};
 }
 
 List::ConstIterator List::end() const noexcept
 {
-    return ConstIterator{&m_tail, &m_tail};
+    return const_cast<List *>(this)->end();
+}
+
+bool List::enable_index()
+{
+    thaw();
+    if (m_pool.capacity() > OrderIndex::MAX_SIZE) {
+        return false;
+    }
+    if (!m_index) {
+        m_index = std::make_unique<OrderIndex>();
+        reindex();
+    }
+    return true;
+}
+
+void List::reindex()
+{
+    if (!m_index) {
+        return;
+    }
+    std::vector<std::size_t> slots;
+    slots.reserve(m_size);
+    for (const auto * node = m_head; node != &m_tail; node = node->m_next) {
+        slots.push_back(m_pool.slot(node));
+    } // O(n log(number of slabs))
+    m_index->assign(slots);
+}
+
+List::Iterator List::at(const std::size_t position)
+{
+    if (position >= m_size) {
+        return end();
+    }
+    if (m_frozen) {
+        return Iterator{this, position};
+    }
+    if (m_index) {
+        return Iterator{this, m_pool.at(m_index->at(position))};
+    }
+    auto * node = m_head;
+    for (std::size_t i = 0; i < position; ++i) {
+        node = node->m_next;
+    }
+    return Iterator{this, node};
+}
+
+List::ConstIterator List::at(const std::size_t position) const
+{
+    return const_cast<List *>(this)->at(position);
+}
+
+std::size_t List::index_of(const ConstIterator position) const
+{
+    if (!position.m_pointer) {
+        return position.m_index;
+    }
+    if (position.m_pointer == &m_tail) {
+        return m_size;
+    }
+    if (m_index) {
+        return m_index->position(m_pool.slot(position.m_pointer));
+    }
+    std::size_t index = 0;
+    for (const auto * node = m_head; node != position.m_pointer; node = node->m_next) {
+        ++index;
+    }
+    return index;
+}
+
+List::ListNode * List::resolve(const ConstIterator & position)
+{
+    if (position.m_pointer) {
+        return position.m_pointer;
+    }
+    // Right after thaw() the node i lies at m_head + i
+    thaw();
+    return position.m_index == m_size ? &m_tail : m_head + position.m_index;
+}
+
+void List::link(const ConstIterator & position, const ConstIterator & target)
+{
+    auto * node = resolve(position);
+    auto * random = resolve(target);
+    if (random == &m_tail) {
+        random = nullptr;
+    }
+    node->m_random = random;
+    if (m_journal) {
+        record(format::Change::LINK, {id(node), random ? id(random) + 1 : 0});
+    }
 }
 
 void List::clear()
 {
-    while (!empty()) {
-        pop_front();
+    static_assert(std::is_trivially_destructible_v<ListNode>);
+    if (m_journal) {
+        record(format::Change::CLEAR, {});
+    }
+    m_pool.release();
+    m_arena.release();
+    m_frozen.reset();
+    if (m_index) {
+        m_index->clear();
+    }
+    m_head = &m_tail;
+    m_tail.m_previous = nullptr;
+    m_size = 0;
+}
+
+bool List::freeze()
+{
+    if (m_frozen) {
+        return true;
+    }
+    if (m_journal || m_size >= std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+    auto frozen = snapshot();
+    // Payloads are copied one after another, so the arena is released
+    std::shared_ptr<char[]> bytes(new char[frozen->m_size]);
+    auto * out = bytes.get();
+    for (std::size_t i = 0; i < m_size; ++i) {
+        auto & view = frozen->m_views[i];
+        const auto * copy = out;
+        out = std::copy(view.begin(), view.end(), out);
+        view = {copy, view.size()};
+    } // O(total size of payloads)
+    frozen->m_blocks = {std::move(bytes)};
+
+    const auto count = m_size;
+    clear();
+    m_frozen = std::move(frozen);
+    m_size = count;
+    return true;
+}
+
+void List::thaw()
+{
+    if (!m_frozen) {
+        return;
     }
+    const auto frozen = std::move(m_frozen);
+    const auto count = m_size;
+    clear();
+    // Nodes are placed into a single block in the order of the list
+    auto * nodes = m_pool.allocate(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto * node = ::new (static_cast<void *>(nodes + i)) ListNode;
+        const auto random = frozen->m_randoms[i];
+        node->m_previous = i == 0 ? nullptr : nodes + i - 1;
+        node->m_next = i + 1 == count ? &m_tail : nodes + i + 1;
+        node->m_random = random == count ? nullptr : nodes + random;
+        node->m_data = frozen->at(i);
+    } // O(n)
+    // Payloads stay where they are
+    m_arena.adopt(std::move(frozen->m_blocks.front()), frozen->m_size);
+    if (count != 0) {
+        m_head = nodes;
+        m_tail.m_previous = nodes + count - 1;
+    }
+    m_size = count;
+    reindex();
 }
 
-namespace serializers {
+namespace {
 
-template <typename T>
-void serialize(const T & value, file_ptr_t file)
+/**
+ * Payloads of the version 1 are terminated with zero bytes.
+ */
+void serialize_v1(const std::string_view data, format::Writer & writer)
 {
-    std::fwrite(&value, sizeof(T), 1, file);
+    writer.write(data);
+    writer.write("", 1);
 }
 
-template <>
-void serialize<std::string>(const std::string & str, file_ptr_t file)
+/**
+ * Frames encoded from a contiguous range of nodes.
+ */
+struct EncodedChunk
+{
+    std::vector<char> m_bytes;
+    /**
+     * Offsets of the frames are counted from the beginning of m_bytes.
+     */
+    std::vector<format::FrameEntry> m_frames;
+    std::vector<std::uint32_t> m_offsets;
+    /**
+     * Frames before compression.
+     */
+    std::vector<char> m_raw;
+};
+
+std::future<int> ready(int status)
 {
-    std::fwrite(str.c_str(), sizeof(char), str.length() + 1, file);
+    std::promise<int> promise;
+    promise.set_value(status);
+    return promise.get_future();
 }
 
-} // namespace serializers
+/**
+ * The number of nodes encoded by a single task. The boundaries of chunks
+ * do not depend on the number of threads, so neither does the output.
+ */
+constexpr std::size_t CHUNK_NODES = 1 << 16;
 
-int List::serialize(file_ptr_t file)
+} // namespace
+
+std::unique_ptr<List::Frozen> List::snapshot() const
 {
-    if (!file) {
-        return -1;
+    if (m_frozen) {
+        return std::make_unique<Frozen>(*m_frozen);
     }
     std::vector<const ListNode *> nodes;
-    std::unordered_map<const ListNode *, std::size_t> indexes;
-    std::size_t index = 0;
-    for (auto it = begin(); it != end(); ++index, ++it) {
-        const auto * node = it.m_pointer;
-        nodes.push_back(node);        // Amortized O(1)
-        indexes.emplace(node, index); // Amortized O(1)
-    }                                 // O(n)
-
+    nodes.reserve(m_size);
+    for (const auto * node = m_head; node != &m_tail; node = node->m_next) {
+        nodes.push_back(node);
+    } // O(n)
+    // Positions of the nodes by the numbers of their slots in the pool
+    std::vector<std::uint32_t> positions(m_pool.capacity());
+    auto frozen = std::make_unique<Frozen>();
+    frozen->m_blocks = m_arena.share();
+    frozen->m_views.reserve(m_size + 1);
+    frozen->m_randoms.reserve(m_size);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        positions[m_pool.slot(nodes[i])] = static_cast<std::uint32_t>(i);
+        frozen->m_size += nodes[i]->m_data.size();
+    } // O(n log(number of slabs))
     for (const auto * node : nodes) {
-        serializers::serialize(node->m_data, file);
-        auto random = NO_RANDOM;
-        if (node->m_random) {
-            random = indexes[node->m_random];
+        frozen->m_views.push_back(node->m_data);
+        const auto * random = node->m_random;
+        frozen->m_randoms.push_back(random ? positions[m_pool.slot(random)] : static_cast<std::uint32_t>(m_size));
+    } // O(n log(number of slabs))
+    frozen->m_views.emplace_back();
+    return frozen;
+}
+
+template <class Payload, class Random>
+int List::encode(io::Sink & sink, const SerializeOptions & options, const std::size_t count, const std::uint64_t payload_size, const Payload & payload, const Random & random)
+{
+    if (options.version != format::VERSION_1 && options.version != format::VERSION_2) {
+        return 2;
+    }
+    format::Header header;
+    header.m_count = count;
+    header.m_payload_size = payload_size;
+    header.m_flags = options.index ? format::FLAG_INDEX : 0;
+
+    // Numbers of the dictionary entries by the positions of the nodes
+    format::Dictionary dictionary;
+    std::vector<std::uint64_t> entries;
+    if (options.compress) {
+        header.m_flags |= format::FLAG_COMPRESSED;
+    }
+    if (options.checksum) {
+        header.m_flags |= format::FLAG_CHECKSUM;
+    }
+    if (options.dictionary && options.version == format::VERSION_2) {
+        header.m_flags |= format::FLAG_DICTIONARY;
+        std::unordered_map<std::string_view, std::uint64_t> numbers;
+        entries.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto data = payload(i);
+            const auto [found, inserted] = numbers.emplace(data, dictionary.size());
+            if (inserted) {
+                dictionary.push_back(data);
+            }
+            entries.push_back(found->second);
+        }
+    } // O(n) on average
+    // A single payload can exceed the limit only if all of them together do
+    if (options.version == format::VERSION_2 && !(header.m_flags & format::FLAG_DICTIONARY) && header.m_payload_size > format::MAX_PAYLOAD_SIZE) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (payload(i).size() > format::MAX_PAYLOAD_SIZE) {
+                return 2;
+            }
         }
-        serializers::serialize(random, file);
     } // O(n)
 
-    return 0;
-}
+    const auto threads = resolve_threads(options.threads);
+    const auto chunks = (count + CHUNK_NODES - 1) / CHUNK_NODES;
+    format::Writer writer(sink);
+    if (options.version == format::VERSION_1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            serialize_v1(payload(i), writer);
+            const auto index = random(i);
+            serializers::Serializer<std::size_t>::serialize(index == 0 ? NO_RANDOM : index - 1, writer);
+        } // O(n)
+        return writer.flush() ? 0 : 1;
+    }
+
+    char buffer[format::HEADER_SIZE];
+    header.encode(buffer);
+    writer.write(buffer, sizeof(buffer));
+    if (header.m_flags & format::FLAG_DICTIONARY) {
+        format::write_dictionary(writer, dictionary, options.checksum);
+    }
 
-namespace deserializers {
+    std::vector<format::FrameEntry> frames;
+    std::vector<std::uint32_t> offsets;
+    if (options.index) {
+        offsets.reserve(count);
+    }
+    // Chunks are encoded in rounds and written in order, so at most one chunk per thread is kept in memory
+    std::vector<EncodedChunk> encoded(threads);
+    for (std::size_t round = 0; round < chunks; round += threads) {
+        const auto tasks = std::min(threads, chunks - round);
+        parallel_for(tasks, threads, [&](const std::size_t i) {
+            auto & chunk = encoded[i];
+            chunk.m_bytes.clear();
+            chunk.m_frames.clear();
+            chunk.m_offsets.clear();
+            const auto first = (round + i) * CHUNK_NODES;
+            const auto last = std::min(count, first + CHUNK_NODES);
+            chunk.m_raw.clear();
+            format::FrameEncoder frame(options.compress ? chunk.m_raw : chunk.m_bytes, options.checksum && !options.compress);
+            auto frame_first = first;
+            for (auto j = first; j < last; ++j) {
+                const auto offset = entries.empty() ? frame.add(payload(j), random(j)) : frame.add_reference(entries[j], random(j));
+                if (options.index) {
+                    chunk.m_offsets.push_back(offset);
+                }
+                if (frame.full() || j + 1 == last) {
+                    chunk.m_frames.push_back({frame.flush(), frame_first});
+                    frame_first = j + 1;
+                }
+            }
+            if (options.compress) {
+                format::compress_frames(chunk.m_raw, chunk.m_frames, chunk.m_bytes, options.checksum);
+            }
+        });
+        for (std::size_t i = 0; i < tasks; ++i) {
+            const auto & chunk = encoded[i];
+            const auto base = writer.offset();
+            for (const auto & entry : chunk.m_frames) {
+                frames.push_back({base + entry.m_offset, entry.m_first});
+            }
+            offsets.insert(offsets.end(), chunk.m_offsets.begin(), chunk.m_offsets.end());
+            writer.write(chunk.m_bytes.data(), chunk.m_bytes.size());
+        }
+    } // O(n)
+    if (options.index) {
+        format::write_index(writer, frames, offsets);
+    }
+    return writer.flush() ? 0 : 1;
+}
 
-template <typename T>
-std::optional<T> deserialize(file_ptr_t file)
+int List::serialize(file_ptr_t file, const SerializeOptions & options)
 {
-    T value;
-    if (std::fread(&value, sizeof(T), 1, file) != 1) {
-        return std::nullopt;
+    if (!file) {
+        return -1;
     }
-    return value;
+    io::FileSink sink(file);
+    return serialize(sink, options);
 }
 
-template <>
-std::optional<std::string> deserialize<std::string>(file_ptr_t file)
+int List::serialize(io::Sink & sink, const SerializeOptions & options)
 {
-    std::vector<char> buffer;
-    char c;
-    while ((c = std::getc(file)) != '\0') {
-        if (c == EOF) {
-            return std::nullopt;
+    // A frozen list is read in place
+    if (m_frozen) {
+        return serialize(sink, options, *m_frozen);
+    }
+    std::vector<const ListNode *> nodes;
+    nodes.reserve(m_size);
+    std::uint64_t payload_size = 0;
+    for (const auto * node = m_head; node != &m_tail; node = node->m_next) {
+        nodes.push_back(node);
+        payload_size += node->m_data.size();
+    } // O(n)
+
+    // Positions of the nodes by the numbers of their slots in the pool
+    const auto threads = resolve_threads(options.threads);
+    const auto chunks = (m_size + CHUNK_NODES - 1) / CHUNK_NODES;
+    std::vector<std::size_t> positions(m_pool.capacity());
+    parallel_for(chunks, threads, [&](const std::size_t chunk) {
+        const auto last = std::min(nodes.size(), (chunk + 1) * CHUNK_NODES);
+        for (auto i = chunk * CHUNK_NODES; i < last; ++i) {
+            positions[m_pool.slot(nodes[i])] = i;
         }
-        buffer.push_back(c);
+    }); // O(n log(number of slabs))
+
+    return encode(
+            sink, options, m_size, payload_size,
+            [&](const std::size_t i) { return nodes[i]->m_data; },
+            [&](const std::size_t i) -> std::size_t {
+                const auto * node = nodes[i]->m_random;
+                return node ? positions[m_pool.slot(node)] + 1 : 0;
+            });
+}
+
+int List::serialize(io::Sink & sink, const SerializeOptions & options, const Frozen & frozen)
+{
+    const auto count = frozen.m_randoms.size();
+    return encode(
+            sink, options, count, frozen.m_size,
+            [&](const std::size_t i) { return frozen.at(i); },
+            [&](const std::size_t i) -> std::size_t {
+                const auto index = frozen.m_randoms[i];
+                return index == count ? 0 : index + 1;
+            });
+}
+
+std::future<int> List::serialize_async(file_ptr_t file, const SerializeOptions & options)
+{
+    if (!file) {
+        return ready(-1);
     }
-    return std::string{buffer.data(), buffer.size()};
+    if (m_size >= std::numeric_limits<std::uint32_t>::max()) {
+        return ready(2);
+    }
+    // The copy shares the bytes of the payloads, which the arena never moves or overwrites
+    return std::async(std::launch::async, [file, options, frozen = snapshot()] {
+        io::FileSink sink(file);
+        return serialize(sink, options, *frozen);
+    });
 }
 
-} // namespace deserializers
 
-int List::deserialize(file_ptr_t file)
+int List::deserialize(file_ptr_t file, const DeserializeOptions & options)
 {
     if (!file) {
         return -1;
     }
-    struct NodeRecord
-    {
-        NodeRecord(const std::string & data, std::size_t random)
-            : m_data(data)
-            , m_random(random)
-        {
+    io::FileSource source(file);
+    return deserialize(source, options);
+}
+
+int List::deserialize(io::Source & source, const DeserializeOptions & options)
+{
+    const auto available = source.remaining();
+    format::Reader reader(source);
+    const auto status = reader.peek(format::MAGIC.size()) == format::MAGIC
+            ? deserialize_v2(reader, available, options)
+            : deserialize_v1(reader);
+    if (status == 0) {
+        m_journal.reset();
+    }
+    return status;
+}
+
+int List::deserialize_v1(format::Reader & reader)
+{
+    // Nodes are created one by one in a fresh pool, so the node i occupies the slot i
+    NodePool<ListNode> pool;
+    PayloadArena arena;
+    std::vector<std::uint64_t> randoms; // Resolved once all nodes exist
+    ListNode * head = &m_tail;
+    ListNode * last = nullptr;
+    std::string buffer;
+    while (!reader.peek(1).empty()) {
+        std::uint64_t random;
+        if (!format::read_record_v1(reader, buffer, random)) {
+            return 1;
         }
-        std::string m_data;
-        std::size_t m_random;
+        auto * node = pool.create();
+        node->m_data = arena.store(buffer);
+        node->m_previous = last;
+        (last ? last->m_next : head) = node;
+        last = node;
+        randoms.push_back(random); // Amortized O(1)
+    }                              // O(n)
+    const auto count = randoms.size();
+    if (std::any_of(randoms.begin(), randoms.end(), [count](std::uint64_t random) { return random > count; })) {
+        return 1;
+    }
+    if (last) {
+        last->m_next = &m_tail;
+    }
+    std::size_t index = 0;
+    for (auto * node = head; node != &m_tail; node = node->m_next, ++index) {
+        const auto random = randoms[index];
+        node->m_random = random == 0 ? nullptr : pool.at(random - 1);
+    } // O(n log(number of slabs))
+
+    clear();
+    m_pool = std::move(pool);
+    m_arena = std::move(arena); // Payloads are not copied once more
+    m_head = head;
+    m_tail.m_previous = last;
+    m_size = count;
+    reindex();
+    return 0;
+}
+
+int List::deserialize_v2(format::Reader & reader, const std::uint64_t available, const DeserializeOptions & options)
+{
+    char buffer[format::HEADER_SIZE];
+    format::Header header;
+    if (!reader.read(buffer, sizeof(buffer)) || !header.decode(buffer)) {
+        return 2;
+    }
+    // Every record takes at least two bytes, so larger values are surely corrupted
+    const auto count = header.m_count;
+    const bool shared = header.m_flags & format::FLAG_DICTIONARY;
+    const bool compressed = header.m_flags & format::FLAG_COMPRESSED;
+    const bool checksummed = header.m_flags & format::FLAG_CHECKSUM;
+    // A compressed byte expands into 255 bytes at most
+    if ((compressed ? count / 255 : count) > available / 2 || (!shared && !compressed && header.m_payload_size > available)) {
+        return 1;
+    }
+
+    // Equal payloads share a single entry of the dictionary, which becomes their storage
+    format::Dictionary dictionary;
+    std::unique_ptr<char[]> entries;
+    std::uint64_t entries_size = 0;
+    if (shared) {
+        char section[format::DICTIONARY_HEADER_SIZE];
+        if (!reader.read(section, sizeof(section))) {
+            return 1;
+        }
+        entries_size = format::get_integer<std::uint64_t>(section + 8);
+        entries = format::read_block(reader, entries_size, available);
+        if (!entries) {
+            return 1;
+        }
+        std::string_view body(entries.get(), entries_size);
+        if ((checksummed && !format::verify_checksum(body)) ||
+            !format::decode_dictionary(body, format::get_integer<std::uint64_t>(section), dictionary)) {
+            return 1;
+        }
+    } // O(size of the dictionary)
+
+    // Frames are read one after another and become the storage of payloads
+    struct Frame
+    {
+        std::unique_ptr<char[]> m_body;
+        std::uint32_t m_size;
+        std::uint32_t m_records;
+        std::uint64_t m_first;
     };
-    std::vector<NodeRecord> records;
-    while (const auto data = deserializers::deserialize<std::string>(file)) {
-        const auto random = deserializers::deserialize<std::size_t>(file);
-        if (!random) {
+    std::vector<Frame> frames;
+    for (std::uint64_t first = 0; first < count;) {
+        char frame[format::FRAME_HEADER_SIZE];
+        if (!reader.read(frame, sizeof(frame))) {
             return 1;
         }
-        records.emplace_back(data.value(), random.value()); // Amortized O(1)
-    }                                                       // O(n)
-    clear();                                                // O(n)
-    std::vector<ListNode *> nodes;
-    for (const auto & record : records) {
-        const auto iterator = push_back(record.m_data); // O(1)
-        nodes.push_back(iterator.m_pointer);            // Amortized O(1)
-    }                                                   // O(n)
+        const auto records = format::get_integer<std::uint32_t>(frame);
+        const auto size = format::get_integer<std::uint32_t>(frame + 4);
+        // The count of a source of unknown size is only trusted as far as frames prove it
+        if (records == 0 || records > count - first || (compressed ? std::uint64_t{size} * 255 : size) / 2 < records) {
+            return 1;
+        }
+        auto body = format::read_block(reader, size, available);
+        if (!body) {
+            return 1;
+        }
+        frames.push_back({std::move(body), size, records, first});
+        first += records;
+    } // O(n)
+
+    // Node i is placed at nodes + i, so every frame is decoded on its own.
+    // The frames hold at least two bytes per record, so count is backed by the data read
+    NodePool<ListNode> pool;
+    auto * nodes = pool.allocate(count);
+    std::atomic<bool> failed{false};
+    parallel_for(frames.size(), options.threads, [&](const std::size_t number) {
+        auto & frame = frames[number];
+        std::string_view stored(frame.m_body.get(), frame.m_size);
+        if (checksummed) {
+            if (!format::verify_checksum(stored)) {
+                failed = true;
+                return;
+            }
+            frame.m_size = static_cast<std::uint32_t>(stored.size());
+        }
+        if (compressed) {
+            // The decompressed body replaces the stored one as the storage of payloads
+            const auto size = format::decompressed_size(stored);
+            if (size == format::UNKNOWN_SIZE || size / 2 < frame.m_records) {
+                failed = true;
+                return;
+            }
+            auto body = std::unique_ptr<char[]>(new char[size]);
+            if (!format::decompress_frame(stored, body.get())) {
+                failed = true;
+                return;
+            }
+            frame.m_body = std::move(body);
+            frame.m_size = static_cast<std::uint32_t>(size);
+        }
+        auto index = frame.m_first;
+        const auto decoded = format::decode_frame({frame.m_body.get(), frame.m_size}, frame.m_records, shared ? &dictionary : nullptr, [&](std::string_view data, std::uint64_t random) {
+            if (random > count) {
+                failed = true;
+                random = 0;
+            }
+            auto * node = ::new (static_cast<void *>(nodes + index)) ListNode;
+            node->m_previous = index == 0 ? nullptr : nodes + index - 1;
+            node->m_next = index + 1 == count ? &m_tail : nodes + index + 1;
+            node->m_random = random == 0 ? nullptr : nodes + random - 1;
+            node->m_data = data;
+            ++index;
+        });
+        if (!decoded) {
+            failed = true;
+        }
+    }); // O(n / threads)
+    if (failed) {
+        return 1;
+    }
+
+    clear();
+    m_pool = std::move(pool);
+    if (shared) {
+        m_arena.adopt(std::move(entries), entries_size);
+    }
+    else {
+        for (auto & frame : frames) {
+            m_arena.adopt(std::move(frame.m_body), frame.m_size);
+        }
+    }
+    if (count != 0) {
+        m_head = nodes;
+        m_tail.m_previous = nodes + count - 1;
+    }
+    m_size = count;
+    reindex();
+    return 0;
+}
+
+void List::compact(const Order order)
+{
+    if (m_frozen || m_size == 0) {
+        return;
+    }
+    std::vector<const ListNode *> nodes;
+    nodes.reserve(m_size);
+    if (order == Order::SEQUENTIAL) {
+        for (const auto * node = m_head; node != &m_tail; node = node->m_next) {
+            nodes.push_back(node);
+        } // O(n)
+    }
+    else {
+        std::vector<bool> placed(m_pool.capacity());
+        for (const auto * start = m_head; start != &m_tail; start = start->m_next) {
+            for (const auto * node = start; node && !placed[m_pool.slot(node)]; node = node->m_random) {
+                placed[m_pool.slot(node)] = true;
+                nodes.push_back(node);
+            }
+        } // O(n log(number of slabs))
+    }
+    // New positions of the nodes by the numbers of their slots in the pool
+    std::vector<std::size_t> positions(m_pool.capacity());
+    std::size_t size = 0;
     for (std::size_t i = 0; i < nodes.size(); ++i) {
-        const auto random = records[i].m_random;
-        if (random == NO_RANDOM) {
-            continue;
+        positions[m_pool.slot(nodes[i])] = i;
+        size += nodes[i]->m_data.size();
+    } // O(n log(number of slabs))
+
+    // Nodes of a fresh pool placed into a single block occupy the slots 0, 1, ...
+    NodePool<ListNode> pool;
+    PayloadArena arena;
+    auto * block = pool.allocate(nodes.size());
+    auto * bytes = arena.allocate(size);
+    const auto relocated = [&](const ListNode * node) {
+        return block + positions[m_pool.slot(node)];
+    };
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto * node = nodes[i];
+        auto * copy = ::new (static_cast<void *>(block + i)) ListNode;
+        copy->m_previous = node->m_previous ? relocated(node->m_previous) : nullptr;
+        copy->m_next = node->m_next == &m_tail ? &m_tail : relocated(node->m_next);
+        copy->m_random = node->m_random ? relocated(node->m_random) : nullptr;
+        copy->m_data = {bytes, node->m_data.size()};
+        bytes = std::copy(node->m_data.begin(), node->m_data.end(), bytes);
+    } // O(n log(number of slabs) + total size of payloads)
+    if (m_journal) {
+        std::vector<std::uint64_t> ids(pool.capacity());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            ids[i] = id(nodes[i]);
         }
-        nodes[i]->m_random = nodes[random];
+        m_journal->m_ids = std::move(ids);
+    }
+
+    m_head = relocated(m_head);
+    m_tail.m_previous = relocated(m_tail.m_previous);
+    m_pool = std::move(pool);
+    m_arena = std::move(arena);
+    reindex();
+}
+
+int List::snapshot(file_ptr_t file, const SerializeOptions & options)
+{
+    if (const auto status = serialize(file, options)) {
+        return status;
+    }
+    // Changes are tracked by nodes
+    thaw();
+    std::vector<ListNode *> nodes;
+    nodes.reserve(m_size);
+    for (auto * node = m_head; node != &m_tail; node = node->m_next) {
+        nodes.push_back(node);
+    } // O(n)
+    track(nodes);
+    return 0;
+}
+
+int List::checkpoint(file_ptr_t journal)
+{
+    if (!journal || !m_journal) {
+        return -1;
+    }
+    if (m_journal->m_count == 0) {
+        return 0;
+    }
+    char header[format::SEGMENT_HEADER_SIZE];
+    std::copy(format::JOURNAL_MAGIC.begin(), format::JOURNAL_MAGIC.end(), header);
+    format::put_u64(header + 4, m_journal->m_count);
+    format::put_u64(header + 12, m_journal->m_changes.size());
+    io::FileSink sink(journal);
+    format::Writer writer(sink);
+    writer.write(header, sizeof(header));
+    writer.write(m_journal->m_changes.data(), m_journal->m_changes.size());
+    if (!writer.flush() || std::fflush(journal) != 0) {
+        return 1;
+    }
+    m_journal->m_changes.clear();
+    m_journal->m_count = 0;
+    return 0;
+}
+
+int List::restore(file_ptr_t snapshot, file_ptr_t journal, const DeserializeOptions & options)
+{
+    if (!snapshot || !journal) {
+        return -1;
+    }
+    List list;
+    if (const auto status = list.deserialize(snapshot, options)) {
+        return status;
+    }
+    std::vector<ListNode *> nodes;
+    nodes.reserve(list.m_size);
+    for (auto * node = list.m_head; node != &list.m_tail; node = node->m_next) {
+        nodes.push_back(node);
     } // O(n)
+    io::FileSource source(journal);
+    const auto available = source.remaining();
+    format::Reader reader(source);
+    if (const auto status = list.replay(reader, available, nodes)) {
+        return status;
+    }
+    list.track(nodes);
+    take(list);
+    return 0;
+}
+
+void List::track(const std::vector<ListNode *> & nodes)
+{
+    auto journal = std::make_unique<Journal>();
+    journal->m_ids.resize(m_pool.capacity());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i]) {
+            journal->m_ids[m_pool.slot(nodes[i])] = i;
+        }
+    } // O(n log(number of slabs))
+    journal->m_next_id = nodes.size();
+    m_journal = std::move(journal);
+}
+
+void List::record(const format::Change kind, const std::initializer_list<std::uint64_t> fields, const std::string_view data)
+{
+    auto & changes = m_journal->m_changes;
+    const auto size = changes.size();
+    changes.resize(size + 1 + (fields.size() + 1) * format::MAX_VARINT_SIZE);
+    auto * out = changes.data() + size;
+    *(out++) = static_cast<char>(kind);
+    for (const auto field : fields) {
+        out = format::put_varint(out, field);
+    }
+    if (kind == format::Change::INSERT || kind == format::Change::ASSIGN) {
+        out = format::put_varint(out, data.size());
+    }
+    changes.resize(static_cast<std::size_t>(out - changes.data()));
+    changes.insert(changes.end(), data.begin(), data.end());
+    ++m_journal->m_count;
+}
+
+std::uint64_t List::id(const ListNode * node) const noexcept
+{
+    return m_journal->m_ids[m_pool.slot(node)];
+}
+
+void List::identify(const ListNode * node)
+{
+    auto & ids = m_journal->m_ids;
+    if (ids.size() < m_pool.capacity()) {
+        ids.resize(m_pool.capacity());
+    }
+    ids[m_pool.slot(node)] = m_journal->m_next_id++;
+}
+
+int List::replay(format::Reader & reader, const std::uint64_t available, std::vector<ListNode *> & nodes)
+{
+    const auto find = [&nodes](const std::uint64_t id) {
+        return id < nodes.size() ? nodes[id] : nullptr;
+    };
+    std::vector<char> body;
+    while (!reader.peek(1).empty()) {
+        char header[format::SEGMENT_HEADER_SIZE];
+        if (!reader.read(header, sizeof(header))) {
+            break; // Interrupted checkpoint
+        }
+        if (std::string_view(header, format::JOURNAL_MAGIC.size()) != format::JOURNAL_MAGIC) {
+            return 2;
+        }
+        const auto count = format::get_integer<std::uint64_t>(header + 4);
+        const auto size = format::get_integer<std::uint64_t>(header + 12);
+        if (size > available) {
+            break;
+        }
+        body.resize(size);
+        if (!reader.read(body.data(), body.size())) {
+            break;
+        }
+
+        const auto * in = body.data();
+        const auto * end = in + body.size();
+        const auto get_data = [&in, end](std::string_view & data) {
+            std::uint64_t length;
+            if (!format::get_varint(in, end, length) || length > static_cast<std::uint64_t>(end - in)) {
+                return false;
+            }
+            data = std::string_view(in, length);
+            in += length;
+            return true;
+        };
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (in == end) {
+                return 1;
+            }
+            const auto kind = static_cast<format::Change>(*(in++));
+            std::uint64_t first;
+            std::uint64_t second;
+            std::string_view data;
+            ListNode * node = nullptr;
+            switch (kind) {
+            case format::Change::INSERT:
+                if (!format::get_varint(in, end, first) || !get_data(data)) {
+                    return 1;
+                }
+                node = first == 0 ? &m_tail : find(first - 1);
+                if (!node) {
+                    return 1;
+                }
+                nodes.push_back(link_before(node, m_arena.store(data)));
+                break;
+            case format::Change::ERASE:
+                if (!format::get_varint(in, end, first) || !(node = find(first))) {
+                    return 1;
+                }
+                erase(ConstIterator{this, node});
+                nodes[first] = nullptr;
+                break;
+            case format::Change::LINK:
+                if (!format::get_varint(in, end, first) || !format::get_varint(in, end, second) || !(node = find(first))) {
+                    return 1;
+                }
+                node->m_random = second == 0 ? nullptr : find(second - 1);
+                if (second != 0 && !node->m_random) {
+                    return 1;
+                }
+                break;
+            case format::Change::ASSIGN:
+                if (!format::get_varint(in, end, first) || !get_data(data) || !(node = find(first))) {
+                    return 1;
+                }
+                discard(std::exchange(node->m_data, m_arena.store(data)));
+                break;
+            case format::Change::CLEAR:
+                clear();
+                std::fill(nodes.begin(), nodes.end(), nullptr);
+                break;
+            default:
+                return 1;
+            }
+        } // O(size of the segment)
+        if (in != end) {
+            return 1;
+        }
+    }
     return 0;
 }
 
+void List::take(List & other)
+{
+    clear();
+    m_pool = std::move(other.m_pool);
+    m_arena = std::move(other.m_arena);
+    m_journal = std::move(other.m_journal);
+    m_frozen = std::move(other.m_frozen);
+    if (other.m_size != 0 && !m_frozen) {
+        m_head = other.m_head;
+        m_tail.m_previous = other.m_tail.m_previous;
+        m_tail.m_previous->m_next = &m_tail;
+    }
+    m_size = other.m_size;
+    other.m_head = &other.m_tail;
+    other.m_tail.m_previous = nullptr;
+    other.m_size = 0;
+    reindex();
+}
+
 } // namespace solution
@@ -0,0 +1,400 @@
+#include "SerializationFormat.h"
+
+#include "Checksum.h"
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace solution::format {
+
+void Header::encode(char * out) const
+{
+    std::copy(MAGIC.begin(), MAGIC.end(), out);
+    put_u16(out + 4, m_version);
+    put_u16(out + 6, m_flags);
+    put_u64(out + 8, m_count);
+    put_u64(out + 16, m_payload_size);
+}
+
+bool Header::decode(const char * in)
+{
+    if (std::string_view(in, MAGIC.size()) != MAGIC) {
+        return false;
+    }
+    m_version = get_integer<std::uint16_t>(in + 4);
+    m_flags = get_integer<std::uint16_t>(in + 6);
+    m_count = get_integer<std::uint64_t>(in + 8);
+    m_payload_size = get_integer<std::uint64_t>(in + 16);
+    return m_version == VERSION_2 && (m_flags & ~KNOWN_FLAGS) == 0;
+}
+
+Writer::Writer(io::Sink & sink)
+    : m_sink(sink)
+{
+    m_buffer.reserve(FRAME_SIZE);
+}
+
+void Writer::write(const char * data, const std::size_t size)
+{
+    m_offset += size;
+    if (m_buffer.size() + size <= m_buffer.capacity()) {
+        m_buffer.insert(m_buffer.end(), data, data + size);
+        return;
+    }
+    flush();
+    if (size < m_buffer.capacity()) {
+        m_buffer.insert(m_buffer.end(), data, data + size);
+    }
+    else if (!m_sink.write(data, size)) {
+        m_good = false;
+    }
+}
+
+bool Writer::flush()
+{
+    if (!m_buffer.empty()) {
+        if (!m_sink.write(m_buffer.data(), m_buffer.size())) {
+            m_good = false;
+        }
+        m_buffer.clear();
+    }
+    if (!m_sink.flush()) {
+        m_good = false;
+    }
+    return m_good;
+}
+
+Reader::Reader(io::Source & source)
+    : m_source(source)
+    , m_buffer(FRAME_SIZE)
+{
+}
+
+Reader::~Reader()
+{
+    if (m_size != m_position) {
+        m_source.unread(m_size - m_position);
+    }
+}
+
+bool Reader::fill()
+{
+    if (m_position != 0) {
+        std::copy(m_buffer.begin() + m_position, m_buffer.begin() + m_size, m_buffer.begin());
+        m_size -= m_position;
+        m_position = 0;
+    }
+    const auto read = m_source.read(m_buffer.data() + m_size, m_buffer.size() - m_size);
+    m_size += read;
+    return read != 0;
+}
+
+bool Reader::read(char * data, std::size_t size)
+{
+    const auto buffered = std::min(size, m_size - m_position);
+    std::memcpy(data, m_buffer.data() + m_position, buffered);
+    m_position += buffered;
+    data += buffered;
+    size -= buffered;
+    if (size == 0) {
+        return true;
+    }
+    if (size >= m_buffer.size()) {
+        return m_source.read(data, size) == size;
+    }
+    while (m_size - m_position < size) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    std::memcpy(data, m_buffer.data() + m_position, size);
+    m_position += size;
+    return true;
+}
+
+std::string_view Reader::peek(const std::size_t size)
+{
+    while (m_size - m_position < size && fill()) {
+    }
+    return {m_buffer.data() + m_position, std::min(size, m_size - m_position)};
+}
+
+bool Reader::read_until(const char delimiter, std::string & out)
+{
+    while (true) {
+        const auto * begin = m_buffer.data() + m_position;
+        const auto * end = m_buffer.data() + m_size;
+        const auto * found = static_cast<const char *>(std::memchr(begin, delimiter, end - begin));
+        if (found) {
+            out.append(begin, found);
+            m_position += found - begin + 1;
+            return true;
+        }
+        out.append(begin, end);
+        m_position = m_size;
+        if (!fill()) {
+            return false;
+        }
+    }
+}
+
+bool read_record_v1(Reader & reader, std::string & data, std::uint64_t & random)
+{
+    data.clear();
+    std::size_t index;
+    if (!reader.read_until('\0', data) || !reader.read(reinterpret_cast<char *>(&index), sizeof(index))) {
+        return false;
+    }
+    random = index == std::numeric_limits<std::size_t>::max() ? 0 : index + 1;
+    return true;
+}
+
+FrameEncoder::FrameEncoder(std::vector<char> & out, const bool checksum)
+    : m_out(out)
+    , m_checksum(checksum)
+{
+}
+
+bool read_block(Reader & reader, const std::uint64_t size, const std::uint64_t available, std::vector<char> & out)
+{
+    if (available != UNKNOWN_SIZE) {
+        if (size > available) {
+            return false;
+        }
+        out.resize(size);
+        return reader.read(out.data(), size);
+    }
+    // Memory is allocated only for the bytes that have arrived
+    constexpr std::uint64_t PIECE = 1 << 20;
+    out.clear();
+    while (out.size() < size) {
+        const auto done = out.size();
+        out.resize(done + std::min(size - done, PIECE));
+        if (!reader.read(out.data() + done, out.size() - done)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<char[]> read_block(Reader & reader, const std::uint64_t size, const std::uint64_t available)
+{
+    std::unique_ptr<char[]> block;
+    if (available != UNKNOWN_SIZE) {
+        if (size <= available) {
+            block.reset(new char[size]);
+        }
+        return block && reader.read(block.get(), size) ? std::move(block) : nullptr;
+    }
+    // The pieces are copied once into the block of the declared size
+    std::vector<char> pieces;
+    if (read_block(reader, size, available, pieces)) {
+        block.reset(new char[size]);
+        std::copy(pieces.begin(), pieces.end(), block.get());
+    }
+    return block;
+}
+
+std::uint32_t FrameEncoder::add(const std::string_view data, const std::uint64_t random)
+{
+    if (m_records == 0) {
+        m_frame = m_out.size();
+        m_out.resize(m_frame + FRAME_HEADER_SIZE);
+    }
+    const auto offset = static_cast<std::uint32_t>(m_out.size() - m_frame - FRAME_HEADER_SIZE);
+    char varint[MAX_VARINT_SIZE];
+    m_out.insert(m_out.end(), varint, put_varint(varint, data.size()));
+    m_out.insert(m_out.end(), data.begin(), data.end());
+    m_out.insert(m_out.end(), varint, put_varint(varint, random));
+    ++m_records;
+    return offset;
+}
+
+std::uint32_t FrameEncoder::add_reference(const std::uint64_t entry, const std::uint64_t random)
+{
+    if (m_records == 0) {
+        m_frame = m_out.size();
+        m_out.resize(m_frame + FRAME_HEADER_SIZE);
+    }
+    const auto offset = static_cast<std::uint32_t>(m_out.size() - m_frame - FRAME_HEADER_SIZE);
+    char varint[2 * MAX_VARINT_SIZE];
+    m_out.insert(m_out.end(), varint, put_varint(put_varint(varint, entry), random));
+    ++m_records;
+    return offset;
+}
+
+std::size_t FrameEncoder::flush()
+{
+    const auto frame = m_frame;
+    if (m_checksum) {
+        append_checksum(m_out, frame + FRAME_HEADER_SIZE);
+    }
+    put_u32(m_out.data() + frame, m_records);
+    put_u32(m_out.data() + frame + sizeof(std::uint32_t), static_cast<std::uint32_t>(m_out.size() - frame - FRAME_HEADER_SIZE));
+    m_records = 0;
+    return frame;
+}
+
+void write_index(Writer & writer, const std::vector<FrameEntry> & frames, const std::vector<std::uint32_t> & records)
+{
+    const auto offset = writer.offset();
+    char buffer[FRAME_ENTRY_SIZE];
+    put_u64(buffer, frames.size());
+    writer.write(buffer, sizeof(std::uint64_t));
+    for (const auto & frame : frames) {
+        put_u64(buffer, frame.m_offset);
+        put_u64(buffer + 8, frame.m_first);
+        writer.write(buffer, FRAME_ENTRY_SIZE);
+    }
+    for (const auto record : records) {
+        put_u32(buffer, record);
+        writer.write(buffer, sizeof(record));
+    }
+    char footer[FOOTER_SIZE];
+    put_u64(footer, offset);
+    std::copy(MAGIC.begin(), MAGIC.end(), footer + 8);
+    writer.write(footer, FOOTER_SIZE);
+}
+
+void compress_frames(const std::vector<char> & in, std::vector<FrameEntry> & frames, std::vector<char> & out, const bool checksum)
+{
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        const auto * frame = in.data() + frames[i].m_offset;
+        const auto * body = frame + FRAME_HEADER_SIZE;
+        const auto size = static_cast<std::size_t>((i + 1 == frames.size() ? in.data() + in.size() : in.data() + frames[i + 1].m_offset) - body);
+        const auto offset = out.size();
+        out.resize(offset + FRAME_HEADER_SIZE + sizeof(std::uint32_t) + lz::bound(size));
+        auto * stored = out.data() + offset + FRAME_HEADER_SIZE;
+        put_u32(stored, static_cast<std::uint32_t>(size));
+        auto compressed = lz::compress(body, size, stored + sizeof(std::uint32_t));
+        if (compressed >= size) {
+            std::copy(body, body + size, stored + sizeof(std::uint32_t));
+            compressed = size;
+        }
+        std::copy(frame, frame + sizeof(std::uint32_t), out.data() + offset);
+        put_u32(out.data() + offset + sizeof(std::uint32_t), static_cast<std::uint32_t>(sizeof(std::uint32_t) + compressed));
+        out.resize(offset + FRAME_HEADER_SIZE + sizeof(std::uint32_t) + compressed);
+        if (checksum) {
+            append_checksum(out, offset + FRAME_HEADER_SIZE);
+            put_u32(out.data() + offset + sizeof(std::uint32_t), static_cast<std::uint32_t>(sizeof(std::uint32_t) + compressed + CHECKSUM_SIZE));
+        }
+        frames[i].m_offset = offset;
+    }
+}
+
+std::uint64_t decompressed_size(const std::string_view body)
+{
+    if (body.size() < sizeof(std::uint32_t)) {
+        return UNKNOWN_SIZE;
+    }
+    const auto size = get_integer<std::uint32_t>(body.data());
+    const auto stored = body.size() - sizeof(std::uint32_t);
+    // A byte of the block expands into 255 bytes at most
+    if (size < stored || size / 255 > stored) {
+        return UNKNOWN_SIZE;
+    }
+    return size;
+}
+
+bool decompress_frame(const std::string_view body, char * out)
+{
+    const auto size = decompressed_size(body);
+    if (size == UNKNOWN_SIZE) {
+        return false;
+    }
+    const auto * in = body.data() + sizeof(std::uint32_t);
+    const auto stored = body.size() - sizeof(std::uint32_t);
+    if (stored == size) {
+        std::copy(in, in + stored, out);
+        return true;
+    }
+    return lz::decompress(in, stored, out, size);
+}
+
+void append_checksum(std::vector<char> & out, const std::size_t first)
+{
+    const auto crc = checksum::crc32c(out.data() + first, out.size() - first);
+    out.resize(out.size() + CHECKSUM_SIZE);
+    put_u32(out.data() + out.size() - CHECKSUM_SIZE, crc);
+}
+
+bool verify_checksum(std::string_view & body)
+{
+    if (body.size() < CHECKSUM_SIZE) {
+        return false;
+    }
+    body.remove_suffix(CHECKSUM_SIZE);
+    return checksum::crc32c(body.data(), body.size()) == get_integer<std::uint32_t>(body.data() + body.size());
+}
+
+bool unpack_frame(const std::uint16_t flags, std::vector<char> & body, std::vector<char> & buffer)
+{
+    std::string_view stored(body.data(), body.size());
+    if ((flags & FLAG_CHECKSUM) && !verify_checksum(stored)) {
+        return false;
+    }
+    if (!(flags & FLAG_COMPRESSED)) {
+        body.resize(stored.size());
+        return true;
+    }
+    const auto size = decompressed_size(stored);
+    if (size == UNKNOWN_SIZE) {
+        return false;
+    }
+    buffer.resize(size);
+    if (!decompress_frame(stored, buffer.data())) {
+        return false;
+    }
+    body.swap(buffer);
+    return true;
+}
+
+void write_dictionary(Writer & writer, const Dictionary & dictionary, const bool checksum)
+{
+    std::uint64_t size = checksum ? CHECKSUM_SIZE : 0;
+    char varint[MAX_VARINT_SIZE];
+    for (const auto entry : dictionary) {
+        size += static_cast<std::uint64_t>(put_varint(varint, entry.size()) - varint) + entry.size();
+    }
+    char header[DICTIONARY_HEADER_SIZE];
+    put_u64(header, dictionary.size());
+    put_u64(header + 8, size);
+    writer.write(header, sizeof(header));
+    std::uint32_t crc = 0;
+    for (const auto entry : dictionary) {
+        const auto length = static_cast<std::size_t>(put_varint(varint, entry.size()) - varint);
+        writer.write(varint, length);
+        writer.write(entry);
+        if (checksum) {
+            crc = checksum::crc32c(entry.data(), entry.size(), checksum::crc32c(varint, length, crc));
+        }
+    }
+    if (checksum) {
+        put_u32(varint, crc);
+        writer.write(varint, CHECKSUM_SIZE);
+    }
+}
+
+bool decode_dictionary(const std::string_view body, const std::uint64_t count, Dictionary & dictionary)
+{
+    // Every entry takes at least one byte
+    if (count > body.size()) {
+        return false;
+    }
+    dictionary.clear();
+    dictionary.reserve(count);
+    const auto * in = body.data();
+    const auto * end = in + body.size();
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t length;
+        if (!get_varint(in, end, length) || length > static_cast<std::uint64_t>(end - in)) {
+            return false;
+        }
+        dictionary.emplace_back(in, length);
+        in += length;
+    }
+    return in == end;
+}
+
+} // namespace solution::format
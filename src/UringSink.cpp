@@ -0,0 +1,333 @@
+#include "UringSink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define SOLUTION_IO_URING
+#endif
+
+namespace solution::io {
+
+namespace {
+
+std::size_t align(const std::size_t size)
+{
+    return (size + UringSink::ALIGNMENT - 1) / UringSink::ALIGNMENT * UringSink::ALIGNMENT;
+}
+
+} // namespace
+
+#ifdef SOLUTION_IO_URING
+
+/**
+ * Submission and completion queues shared with the kernel (liburing is not
+ * required, the rings are mapped with the raw system calls).
+ */
+struct UringSink::Ring
+{
+    static std::unique_ptr<Ring> create()
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const auto fd = static_cast<int>(syscall(__NR_io_uring_setup, ENTRIES, &params));
+        if (fd < 0) {
+            return nullptr;
+        }
+        auto ring = std::make_unique<Ring>();
+        ring->m_fd = fd;
+        if (!supports(fd, IORING_OP_WRITE)) {
+            return nullptr;
+        }
+        ring->m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            ring->m_sq_size = ring->m_cq_size = std::max(ring->m_sq_size, ring->m_cq_size);
+        }
+        ring->m_sq = map(fd, ring->m_sq_size, IORING_OFF_SQ_RING);
+        if (!ring->m_sq) {
+            return nullptr;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            ring->m_cq = ring->m_sq;
+            ring->m_cq_size = 0;
+        }
+        else if (!(ring->m_cq = map(fd, ring->m_cq_size, IORING_OFF_CQ_RING))) {
+            return nullptr;
+        }
+        ring->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        ring->m_sqes = static_cast<io_uring_sqe *>(map(fd, ring->m_sqes_size, IORING_OFF_SQES));
+        if (!ring->m_sqes) {
+            return nullptr;
+        }
+        ring->m_sq_tail = field(ring->m_sq, params.sq_off.tail);
+        ring->m_sq_mask = *field(ring->m_sq, params.sq_off.ring_mask);
+        ring->m_sq_array = field(ring->m_sq, params.sq_off.array);
+        ring->m_cq_head = field(ring->m_cq, params.cq_off.head);
+        ring->m_cq_tail = field(ring->m_cq, params.cq_off.tail);
+        ring->m_cq_mask = *field(ring->m_cq, params.cq_off.ring_mask);
+        ring->m_cqes = reinterpret_cast<io_uring_cqe *>(static_cast<char *>(ring->m_cq) + params.cq_off.cqes);
+        return ring;
+    }
+
+    Ring() = default;
+    Ring(const Ring &) = delete;
+    Ring & operator=(const Ring &) = delete;
+
+    ~Ring()
+    {
+        if (m_sqes) {
+            munmap(m_sqes, m_sqes_size);
+        }
+        if (m_cq && m_cq != m_sq) {
+            munmap(m_cq, m_cq_size);
+        }
+        if (m_sq) {
+            munmap(m_sq, m_sq_size);
+        }
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    bool write(const int fd, const char * data, const std::size_t size, const std::uint64_t offset, const std::uint64_t tag)
+    {
+        const auto tail = *m_sq_tail;
+        const auto index = tail & m_sq_mask;
+        auto & sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(data);
+        sqe.len = static_cast<std::uint32_t>(size);
+        sqe.off = offset;
+        sqe.user_data = tag;
+        m_sq_array[index] = index;
+        __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+        return enter(1, 0);
+    }
+
+    /**
+     * Waits for a completion.
+     *
+     * @return false if the wait has failed.
+     */
+    template <typename Handler>
+    bool complete(Handler && handler)
+    {
+        auto head = *m_cq_head;
+        while (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+            if (!enter(0, 1)) {
+                return false;
+            }
+        }
+        const auto & cqe = m_cqes[head & m_cq_mask];
+        handler(cqe.user_data, cqe.res);
+        __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    static constexpr unsigned ENTRIES = 2;
+
+    static void * map(const int fd, const std::size_t size, const off_t offset)
+    {
+        auto * result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return result == MAP_FAILED ? nullptr : result;
+    }
+
+    /**
+     * Rings are set up since Linux 5.1, but IORING_OP_WRITE and the probe of
+     * operations appeared in 5.6 only, so older kernels fail the probe.
+     */
+    static bool supports(const int fd, const unsigned opcode)
+    {
+        constexpr unsigned OPERATIONS = 64;
+        alignas(io_uring_probe) char buffer[sizeof(io_uring_probe) + OPERATIONS * sizeof(io_uring_probe_op)] = {};
+        auto * probe = reinterpret_cast<io_uring_probe *>(buffer);
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, OPERATIONS) < 0 || opcode > probe->last_op) {
+            return false;
+        }
+        return probe->ops[opcode].flags & IO_URING_OP_SUPPORTED;
+    }
+
+    static unsigned * field(void * ring, const std::uint32_t offset)
+    {
+        return reinterpret_cast<unsigned *>(static_cast<char *>(ring) + offset);
+    }
+
+    bool enter(const unsigned submit, const unsigned wait)
+    {
+        const unsigned flags = wait != 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (syscall(__NR_io_uring_enter, m_fd, submit, wait, flags, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int m_fd = -1;
+    void * m_sq = nullptr;
+    std::size_t m_sq_size = 0;
+    void * m_cq = nullptr;
+    std::size_t m_cq_size = 0;
+    io_uring_sqe * m_sqes = nullptr;
+    std::size_t m_sqes_size = 0;
+
+    unsigned * m_sq_tail = nullptr;
+    unsigned m_sq_mask = 0;
+    unsigned * m_sq_array = nullptr;
+    unsigned * m_cq_head = nullptr;
+    unsigned * m_cq_tail = nullptr;
+    unsigned m_cq_mask = 0;
+    io_uring_cqe * m_cqes = nullptr;
+};
+
+#else
+
+struct UringSink::Ring
+{
+    static std::unique_ptr<Ring> create() { return nullptr; }
+
+    bool write(int, const char *, std::size_t, std::uint64_t, std::uint64_t) { return false; }
+
+    template <typename Handler>
+    bool complete(Handler &&)
+    {
+        return false;
+    }
+};
+
+#endif
+
+void UringSink::Free::operator()(char * buffer) const noexcept
+{
+    std::free(buffer);
+}
+
+UringSink::UringSink(const char * path, const std::size_t buffer_size)
+    : m_capacity(align(std::max<std::size_t>(buffer_size, 1)))
+{
+    constexpr auto flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+    m_fd = open(path, flags | O_DIRECT, 0644);
+    m_direct = m_fd >= 0;
+    if (m_fd < 0 && errno == EINVAL) {
+        m_fd = open(path, flags, 0644);
+    }
+#else
+    m_fd = open(path, flags, 0644);
+#endif
+    if (m_fd < 0) {
+        return;
+    }
+    for (auto & buffer : m_buffers) {
+        buffer.reset(static_cast<char *>(std::aligned_alloc(ALIGNMENT, m_capacity)));
+        if (!buffer) {
+            return;
+        }
+    }
+    m_ring = Ring::create();
+    m_good = true;
+}
+
+UringSink::~UringSink()
+{
+    if (m_fd >= 0) {
+        flush();
+        close(m_fd);
+    }
+}
+
+bool UringSink::write(const char * data, std::size_t size)
+{
+    if (!m_good) {
+        return false;
+    }
+    while (size != 0) {
+        const auto count = std::min(size, m_capacity - m_used);
+        wait(m_current); // The buffer may be written by flush()
+        std::memcpy(m_buffers[m_current].get() + m_used, data, count);
+        m_used += count;
+        data += count;
+        size -= count;
+        if (m_used == m_capacity) {
+            submit(m_current, m_capacity, m_offset);
+            m_offset += m_capacity;
+            m_current ^= 1;
+            m_used = 0;
+        }
+    }
+    return m_good;
+}
+
+bool UringSink::flush()
+{
+    if (!m_good) {
+        return false;
+    }
+    if (m_used != 0) {
+        wait(m_current);
+        const auto size = align(m_used);
+        std::memset(m_buffers[m_current].get() + m_used, 0, size - m_used);
+        submit(m_current, size, m_offset);
+    }
+    wait(0);
+    wait(1);
+    if (m_good && ftruncate(m_fd, static_cast<off_t>(m_offset + m_used)) != 0) {
+        m_good = false;
+    }
+    return m_good;
+}
+
+void UringSink::submit(const std::size_t buffer, const std::size_t size, const std::uint64_t offset)
+{
+    const auto * data = m_buffers[buffer].get();
+    if (m_ring) {
+        if (m_ring->write(m_fd, data, size, offset, buffer)) {
+            m_pending[buffer] = size;
+        }
+        else {
+            m_good = false;
+        }
+        return;
+    }
+    for (std::size_t written = 0; written < size;) {
+        const auto result = pwrite(m_fd, data + written, size - written, static_cast<off_t>(offset + written));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            m_good = false;
+            return;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+}
+
+void UringSink::wait(const std::size_t buffer)
+{
+    while (m_pending[buffer] != 0) {
+        const auto completed = m_ring->complete([this](const std::uint64_t tag, const std::int32_t result) {
+            // Short direct writes are not resumed, they do not happen on regular files
+            if (result < 0 || static_cast<std::size_t>(result) != m_pending[tag]) {
+                m_good = false;
+            }
+            m_pending[tag] = 0;
+        });
+        if (!completed) {
+            m_good = false;
+            m_pending[0] = m_pending[1] = 0;
+        }
+    }
+}
+
+} // namespace solution::io
@@ -2,8 +2,46 @@
 #include "RemovingDuplicates.h"
 #include "Serialization.h"
 
-int main()
+#include <cstdio>
+#include <fcntl.h>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * Removes duplicates from the file arguments[0] (or stdin) to the file arguments[1] (or stdout).
+ */
+int remove_duplicates_command(const int count, char ** arguments)
 {
+    const auto input = count > 0 ? ::open(arguments[0], O_RDONLY) : STDIN_FILENO;
+    if (input < 0) {
+        std::fprintf(stderr, "cannot open %s\n", arguments[0]);
+        return 1;
+    }
+    const auto output = count > 1 ? ::open(arguments[1], O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (output < 0) {
+        std::fprintf(stderr, "cannot open %s\n", arguments[1]);
+        return 1;
+    }
+    const auto status = solution::remove_duplicates(input, output);
+    if (status != 0) {
+        std::fprintf(stderr, "remove duplicates failed: %d\n", status);
+    }
+    return status;
+}
+
+} // namespace
+
+/**
+ * Shows the solutions, "--remove-duplicates [input [output]]" streams a file instead.
+ */
+int main(int argc, char ** argv)
+{
+    if (argc > 1 && std::string_view(argv[1]) == "--remove-duplicates") {
+        return remove_duplicates_command(argc - 2, argv + 2);
+    }
+
     std::cout << "1. Binary representation of 10 (uint8_t) is ";
     solution::print_binary_representation<uint8_t>(10);
     std::cout << "\n" << std::endl;
@@ -34,7 +72,7 @@ int main()
               << list.size() << "] {" << std::endl;
     for (auto it = list.begin(); it != list.end(); ++it) {
         std::cout << "    '" << *it << "' -> "
-                  << (it.next() == list.end() ? "nullptr" : "'" + *it.next() + "'") << std::endl;
+                  << (it.next() == list.end() ? "nullptr" : "'" + std::string(*it.next()) + "'") << std::endl;
     }
     std::cout << "}" << std::endl;
 
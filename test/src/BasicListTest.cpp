@@ -0,0 +1,174 @@
+#include "BasicList.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace test {
+
+struct Point
+{
+    double m_x;
+    double m_y;
+};
+
+/**
+ * Not trivially copyable, encoded by a custom serializer.
+ */
+struct Person
+{
+    std::string m_name;
+    std::uint32_t m_age = 0;
+};
+
+} // namespace test
+
+template <>
+struct solution::serializers::Serializer<test::Person>
+{
+    static constexpr bool BULK = false;
+
+    static void serialize(const test::Person & value, format::Writer & writer)
+    {
+        Serializer<std::string>::serialize(value.m_name, writer);
+        Serializer<std::uint32_t>::serialize(value.m_age, writer);
+    }
+
+    static bool deserialize(test::Person & value, format::Reader & reader)
+    {
+        return Serializer<std::string>::deserialize(value.m_name, reader) &&
+                Serializer<std::uint32_t>::deserialize(value.m_age, reader);
+    }
+};
+
+namespace test {
+
+namespace {
+
+template <typename T>
+void round_trip(solution::BasicList<T> & list, solution::BasicList<T> & deserialized)
+{
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    ASSERT_EQ(list.serialize(sink), 0);
+    solution::io::MemorySource source(buffer.data(), buffer.size());
+    ASSERT_EQ(deserialized.deserialize(source), 0);
+    ASSERT_EQ(source.remaining(), 0);
+}
+
+} // namespace
+
+TEST(BasicListTest, modification)
+{
+    solution::BasicList<int> list;
+    list.push_back(2);
+    list.push_front(1);
+    list.insert(list.end(), 4);
+    list.insert(std::prev(list.end()), 3);
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{1, 2, 3, 4}));
+
+    *list.begin() = 10;
+    list.erase(std::next(list.begin()));
+    list.pop_back();
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{10, 3}));
+    ASSERT_EQ(*std::prev(list.end()), 3);
+
+    list.clear();
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.begin(), list.end());
+}
+
+TEST(BasicListTest, bulk_serialization)
+{
+    solution::BasicList<Point> list;
+    // More values than a single block holds
+    for (int i = 0; i < 10000; ++i) {
+        list.push_back({i * 0.5, -i * 0.25});
+    }
+    auto first = list.begin();
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        it.link(first);
+        first = it;
+    }
+    std::prev(list.end()).link(list.end());
+
+    solution::BasicList<Point> deserialized;
+    deserialized.push_back({1, 2});
+    round_trip(list, deserialized);
+    ASSERT_EQ(deserialized.size(), list.size());
+    auto it = deserialized.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_EQ(it->m_x, jt->m_x);
+        ASSERT_EQ(it->m_y, jt->m_y);
+        if (jt.next() == list.end()) {
+            ASSERT_EQ(it.next(), deserialized.end());
+        }
+        else {
+            ASSERT_EQ(it.next()->m_x, jt.next()->m_x);
+        }
+    }
+    ASSERT_EQ(it, deserialized.end());
+}
+
+TEST(BasicListTest, custom_serializer)
+{
+    solution::BasicList<Person> list;
+    list.push_back({"Alice", 30});
+    list.push_back({std::string(100000, 'b'), 40});
+    list.push_back({"", 50});
+    std::next(list.begin()).link(std::prev(list.end()));
+
+    solution::BasicList<Person> deserialized;
+    round_trip(list, deserialized);
+    ASSERT_EQ(deserialized.size(), 3);
+    auto it = deserialized.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_EQ(it->m_name, jt->m_name);
+        ASSERT_EQ(it->m_age, jt->m_age);
+    }
+    ASSERT_EQ(deserialized.begin().next(), deserialized.end());
+    ASSERT_EQ(std::next(deserialized.begin()).next()->m_age, 50);
+}
+
+TEST(BasicListTest, invalid_data)
+{
+    solution::BasicList<std::uint32_t> list;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    ASSERT_EQ(list.serialize(sink), 0);
+
+    // Values of another size
+    solution::BasicList<std::uint64_t> other;
+    solution::io::MemorySource source(buffer.data(), buffer.size());
+    ASSERT_EQ(other.deserialize(source), 2);
+
+    solution::BasicList<std::uint32_t> deserialized;
+    deserialized.push_back(42);
+    for (const auto size : {buffer.size() - 1, std::size_t{20}, std::size_t{0}}) {
+        solution::io::MemorySource truncated(buffer.data(), size);
+        ASSERT_EQ(deserialized.deserialize(truncated), 1);
+    }
+    // The "random" index is out of range
+    buffer[buffer.size() - 8] = 101;
+    solution::io::MemorySource corrupted(buffer.data(), buffer.size());
+    ASSERT_EQ(deserialized.deserialize(corrupted), 1);
+    // The size of a pipe is unknown, so the count is checked only against the nodes read
+    solution::format::put_u64(buffer.data(), std::uint64_t{1} << 60);
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::write(fds[1], buffer.data(), buffer.size()), static_cast<ssize_t>(buffer.size()));
+    ::close(fds[1]);
+    solution::io::FdSource pipe(fds[0]);
+    ASSERT_EQ(deserialized.deserialize(pipe), 1);
+    ::close(fds[0]);
+    ASSERT_EQ(deserialized.size(), 1);
+    ASSERT_EQ(*deserialized.begin(), 42);
+}
+
+} // namespace test
@@ -0,0 +1,38 @@
+#include "Checksum.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+namespace test {
+
+TEST(ChecksumTest, known_values)
+{
+    ASSERT_EQ(solution::checksum::crc32c("", 0), 0);
+    ASSERT_EQ(solution::checksum::crc32c("123456789", 9), 0xe3069283);
+    ASSERT_EQ(solution::checksum::crc32c_portable("123456789", 9), 0xe3069283);
+    const std::string zeros(32, '\0');
+    ASSERT_EQ(solution::checksum::crc32c(zeros.data(), zeros.size()), 0x8a9136aa);
+}
+
+TEST(ChecksumTest, implementations_agree)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string data(10000, '\0');
+    for (auto & c : data) {
+        c = static_cast<char>(byte(generator));
+    }
+    // Different sizes and alignments
+    for (std::size_t first = 0; first < 8; ++first) {
+        for (const std::size_t size : {0, 1, 7, 8, 9, 63, 1000, 9000}) {
+            ASSERT_EQ(solution::checksum::crc32c(data.data() + first, size), solution::checksum::crc32c_portable(data.data() + first, size));
+        }
+    }
+    // Piece by piece
+    const auto whole = solution::checksum::crc32c(data.data(), data.size());
+    ASSERT_EQ(solution::checksum::crc32c(data.data() + 1234, data.size() - 1234, solution::checksum::crc32c(data.data(), 1234)), whole);
+    ASSERT_EQ(solution::checksum::crc32c_portable(data.data() + 1234, data.size() - 1234, solution::checksum::crc32c_portable(data.data(), 1234)), whole);
+}
+
+} // namespace test
@@ -0,0 +1,71 @@
+#include "Compression.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+std::size_t round_trip(const std::string & data)
+{
+    std::vector<char> compressed(solution::lz::bound(data.size()));
+    const auto size = solution::lz::compress(data.data(), data.size(), compressed.data());
+    EXPECT_LE(size, compressed.size());
+    std::string decompressed(data.size(), '\0');
+    EXPECT_TRUE(solution::lz::decompress(compressed.data(), size, decompressed.data(), decompressed.size()));
+    EXPECT_EQ(decompressed, data);
+    return size;
+}
+
+} // namespace
+
+TEST(CompressionTest, round_trip)
+{
+    round_trip("");
+    round_trip("a");
+    round_trip("Hello, world!");
+    ASSERT_LT(round_trip(std::string(100000, 'a')), 1000);
+
+    std::string text;
+    for (std::size_t i = 0; text.size() < 100000; ++i) {
+        text += "status: " + std::string(i % 3 == 0 ? "completed" : "pending") + ", id: " + std::to_string(i) + '\n';
+    }
+    ASSERT_LT(round_trip(text) * 3, text.size());
+}
+
+TEST(CompressionTest, incompressible)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string data(100000, '\0');
+    for (auto & c : data) {
+        c = static_cast<char>(byte(generator));
+    }
+    ASSERT_LE(round_trip(data), solution::lz::bound(data.size()));
+
+    // Long literal runs followed by matches
+    data += data.substr(0, 5000);
+    round_trip(data);
+}
+
+TEST(CompressionTest, malformed)
+{
+    const std::string data(1000, 'x');
+    std::vector<char> compressed(solution::lz::bound(data.size()));
+    const auto size = solution::lz::compress(data.data(), data.size(), compressed.data());
+    std::string decompressed(data.size(), '\0');
+
+    ASSERT_FALSE(solution::lz::decompress(compressed.data(), size - 1, decompressed.data(), decompressed.size()));
+    ASSERT_FALSE(solution::lz::decompress(compressed.data(), size, decompressed.data(), decompressed.size() - 1));
+    std::string larger(data.size() + 1, '\0');
+    ASSERT_FALSE(solution::lz::decompress(compressed.data(), size, larger.data(), larger.size()));
+
+    // The match refers to the bytes before the beginning
+    const char distance[] = {'\x10', 'x', '\x05', '\0', '\0'};
+    ASSERT_FALSE(solution::lz::decompress(distance, sizeof(distance), decompressed.data(), 5));
+}
+
+} // namespace test
@@ -0,0 +1,205 @@
+#include "ConcurrentList.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+std::vector<std::string> elements(const solution::ConcurrentList & list)
+{
+    solution::ConcurrentList::Guard guard(list);
+    std::vector<std::string> result;
+    for (const auto & data : list) {
+        result.push_back(data);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(ConcurrentListTest, single_thread)
+{
+    solution::ConcurrentList list;
+    ASSERT_TRUE(list.empty());
+    solution::ConcurrentList::Guard guard(list);
+    const auto second = list.push_back("2");
+    const auto first = list.push_front("1");
+    const auto fourth = list.push_back("4");
+    const auto third = list.insert(fourth, "3");
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"1", "2", "3", "4"}));
+    ASSERT_EQ(*std::prev(list.end()), "4");
+    ASSERT_EQ(*--std::prev(list.end()), "3");
+
+    ASSERT_EQ(first.next(), list.end());
+    list.link(first, third);
+    list.link(third, first);
+    ASSERT_EQ(*first.next(), "3");
+    ASSERT_EQ(*first.next().next(), "1");
+    ASSERT_EQ(second.next(), list.end());
+
+    ASSERT_TRUE(list.erase(third));
+    ASSERT_TRUE(third.erased());
+    ASSERT_FALSE(list.erase(third));
+    ASSERT_FALSE(list.erase(list.end()));
+    // The erased node still leads to the rest of the list
+    ASSERT_EQ(*std::next(third), "4");
+    ASSERT_EQ(first.next(), list.end());
+    ASSERT_EQ(list.insert(third, "lost"), list.end());
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"1", "2", "4"}));
+    ASSERT_EQ(list.size(), 3);
+}
+
+TEST(ConcurrentListTest, reuse)
+{
+    solution::ConcurrentList list;
+    {
+        solution::ConcurrentList::Guard guard(list);
+        const auto anchor = list.push_back("anchor");
+        for (int i = 0; i < 10000; ++i) {
+            const auto it = list.push_back(std::to_string(i));
+            list.link(anchor, it);
+            ASSERT_EQ(*anchor.next(), std::to_string(i));
+            ASSERT_TRUE(list.erase(it));
+            // A link to the erased node never leads to its reused memory
+            ASSERT_EQ(anchor.next(), list.end());
+        }
+    }
+    for (int i = 0; i < 10000; ++i) {
+        solution::ConcurrentList::Guard guard(list);
+        ASSERT_TRUE(list.erase(list.push_front(std::to_string(i))));
+    }
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"anchor"}));
+}
+
+TEST(ConcurrentListTest, stress)
+{
+    constexpr int WRITERS = 3;
+    constexpr int READERS = 3;
+    constexpr int OPERATIONS = 20000;
+
+    solution::ConcurrentList list;
+    {
+        solution::ConcurrentList::Guard guard(list);
+        for (int i = 0; i < 100; ++i) {
+            list.push_back("initial");
+        }
+    }
+    std::atomic<int> inserted{0};
+    std::atomic<int> erased{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> failed{false};
+
+    // Payloads of a writer are prefixed by its number, so readers check that they are intact
+    const auto writer = [&](int number) {
+        std::mt19937 generator(number);
+        const auto prefix = std::string(64, static_cast<char>('a' + number));
+        for (int i = 0; i < OPERATIONS; ++i) {
+            solution::ConcurrentList::Guard guard(list);
+            auto it = list.begin();
+            for (auto steps = generator() % 16; steps > 0 && it != list.end(); --steps) {
+                ++it;
+            }
+            switch (generator() % 4) {
+            case 0:
+                if (list.insert(it, prefix + std::to_string(i)) != list.end()) {
+                    ++inserted;
+                }
+                break;
+            case 1:
+                // The first element may be erased by another writer, the insertion still succeeds
+                if (list.push_front(prefix + std::to_string(i)) == list.end()) {
+                    failed = true;
+                }
+                ++inserted;
+                break;
+            case 2:
+                if (it != list.end() && list.erase(it)) {
+                    ++erased;
+                }
+                break;
+            default:
+                if (it != list.end()) {
+                    list.link(it, list.begin());
+                    list.link(list.begin(), it);
+                }
+            }
+        }
+    };
+    const auto reader = [&] {
+        while (!stop) {
+            solution::ConcurrentList::Guard guard(list);
+            std::size_t count = 0;
+            for (auto it = list.begin(); it != list.end() && count < 1000000; ++it, ++count) {
+                const auto & data = *it;
+                if (data != "initial" && data.substr(0, 64) != std::string(64, data[0])) {
+                    failed = true;
+                }
+                const auto random = it.next();
+                if (random != list.end() && random->empty()) {
+                    failed = true;
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < READERS; ++i) {
+        threads.emplace_back(reader);
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < WRITERS; ++i) {
+        writers.emplace_back(writer, i);
+    }
+    for (auto & thread : writers) {
+        thread.join();
+    }
+    stop = true;
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(failed);
+
+    const auto result = elements(list);
+    ASSERT_EQ(result.size(), 100 + inserted - erased);
+    ASSERT_EQ(list.size(), result.size());
+    // Links in both directions agree
+    solution::ConcurrentList::Guard guard(list);
+    std::size_t count = 0;
+    for (auto it = list.end(); it != list.begin(); --it) {
+        ++count;
+    }
+    ASSERT_EQ(count, result.size());
+}
+
+TEST(ConcurrentListTest, all_guards_taken)
+{
+    // Every place is taken by a thread that modifies the list while holding its guard
+    solution::ConcurrentList list;
+    std::atomic<std::size_t> ready{0};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < solution::ConcurrentList::MAX_GUARDS; ++i) {
+        threads.emplace_back([&list, &ready, i] {
+            solution::ConcurrentList::Guard guard(list);
+            ++ready;
+            while (ready < solution::ConcurrentList::MAX_GUARDS) {
+                std::this_thread::yield();
+            }
+            const auto it = list.push_back(std::to_string(i));
+            solution::ConcurrentList::Guard nested(list);
+            list.push_front(std::to_string(i));
+            ASSERT_TRUE(list.erase(it));
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(list.size(), solution::ConcurrentList::MAX_GUARDS);
+}
+
+} // namespace test
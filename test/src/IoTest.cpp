@@ -0,0 +1,145 @@
+#include "Serialization.h"
+#include "UringSink.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+void fill(solution::List & list, const std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        list.push_back("value " + std::to_string(i * 7919 % 1000));
+    }
+    auto first = list.begin();
+    for (auto it = std::next(first); it != list.end(); ++it, ++first) {
+        it.link(first);
+    }
+}
+
+void expect_equal(solution::List & expected, solution::List & actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    auto it = actual.begin();
+    for (auto jt = expected.begin(); jt != expected.end(); ++it, ++jt) {
+        ASSERT_EQ(*it, *jt);
+        if (jt.next() == expected.end()) {
+            ASSERT_EQ(it.next(), actual.end());
+        }
+        else {
+            ASSERT_EQ(*it.next(), *jt.next());
+        }
+    }
+}
+
+std::string read_file(const char * path)
+{
+    std::string content;
+    auto * file = std::fopen(path, "rb");
+    char buffer[4096];
+    for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file)) != 0;) {
+        content.append(buffer, read);
+    }
+    std::fclose(file);
+    return content;
+}
+
+} // namespace
+
+TEST(IoTest, memory)
+{
+    solution::List list;
+    fill(list, 1000);
+    for (const auto & options : {solution::SerializeOptions{solution::format::VERSION_1}, solution::SerializeOptions{}}) {
+        std::vector<char> buffer;
+        solution::io::BufferSink sink(buffer);
+        ASSERT_EQ(list.serialize(sink, options), 0);
+        const auto size = buffer.size();
+        if (options.version == solution::format::VERSION_2) {
+            // The version 1 is read to the end of the source
+            buffer.push_back('!');
+        }
+
+        solution::io::MemorySource source(buffer.data(), buffer.size());
+        solution::List deserialized;
+        ASSERT_EQ(deserialized.deserialize(source), 0);
+        expect_equal(list, deserialized);
+        // The byte that follows the list is not consumed
+        ASSERT_EQ(source.position(), size);
+
+        solution::io::MemorySource truncated(buffer.data(), size - 1);
+        ASSERT_NE(deserialized.deserialize(truncated), 0);
+    }
+}
+
+TEST(IoTest, file_descriptor)
+{
+    solution::List list;
+    fill(list, 100000);
+    auto fd = open("buffer", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    solution::io::FdSink sink(fd);
+    ASSERT_EQ(list.serialize(sink), 0);
+    ASSERT_TRUE(sink.write("tail", 4));
+    close(fd);
+
+    fd = open("buffer", O_RDONLY);
+    solution::io::FdSource source(fd);
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(source), 0);
+    expect_equal(list, deserialized);
+    char tail[5] = {};
+    ASSERT_EQ(source.read(tail, sizeof(tail)), 4);
+    ASSERT_STREQ(tail, "tail");
+    close(fd);
+}
+
+TEST(IoTest, uring)
+{
+    solution::List list;
+    fill(list, 100000);
+    std::vector<char> expected;
+    solution::io::BufferSink buffer(expected);
+    ASSERT_EQ(list.serialize(buffer), 0);
+    expected.insert(expected.end(), {'t', 'a', 'i', 'l'});
+    {
+        solution::io::UringSink sink("buffer", 1 << 14);
+        ASSERT_TRUE(sink.good());
+        ASSERT_EQ(list.serialize(sink), 0);
+        // The padded tail is written once more
+        ASSERT_TRUE(sink.write("tail", 4));
+        ASSERT_TRUE(sink.flush());
+    }
+    ASSERT_EQ(read_file("buffer"), std::string(expected.data(), expected.size()));
+
+    auto * file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    expect_equal(list, deserialized);
+}
+
+TEST(IoTest, uring_small_writes)
+{
+    std::string expected;
+    {
+        solution::io::UringSink sink("buffer", 1);
+        for (std::size_t i = 0; i < 3000; ++i) {
+            const auto piece = std::to_string(i) + ",";
+            ASSERT_TRUE(sink.write(piece.data(), piece.size()));
+            expected += piece;
+            if (i % 1000 == 0) {
+                ASSERT_TRUE(sink.flush());
+                ASSERT_EQ(read_file("buffer"), expected);
+            }
+        }
+    }
+    ASSERT_EQ(read_file("buffer"), expected);
+}
+
+} // namespace test
@@ -0,0 +1,180 @@
+#include "ListReader.h"
+#include "Serialization.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+constexpr std::size_t SIZE = 100000;
+
+/**
+ * Serializes the list {"0", "1", ...} where the element i is linked with the element i / 2.
+ */
+void write_list(const solution::SerializeOptions & options)
+{
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes;
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        nodes.push_back(list.push_back(std::to_string(i)));
+    }
+    for (std::size_t i = 1; i < SIZE; i += 2) {
+        nodes[i].link(nodes[i / 2]);
+    }
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+}
+
+void check_reader(bool indexed)
+{
+    auto * file = std::fopen("buffer", "rb");
+    solution::ListReader reader;
+    ASSERT_EQ(reader.open(file), 0);
+    ASSERT_EQ(reader.indexed(), indexed);
+    ASSERT_EQ(reader.size(), SIZE);
+
+    solution::ListReader::Element element;
+    for (const std::size_t i : {SIZE - 1, std::size_t{0}, std::size_t{77777}, std::size_t{12345}, std::size_t{12346}}) {
+        ASSERT_EQ(reader.read(i, element), 0);
+        ASSERT_EQ(element.m_data, std::to_string(i));
+        ASSERT_EQ(element.m_random, i % 2 == 1 ? i / 2 : solution::ListReader::NO_RANDOM);
+    }
+
+    std::vector<solution::ListReader::Element> elements;
+    ASSERT_EQ(reader.read(5000, 30000, elements), 0);
+    ASSERT_EQ(elements.size(), 25000);
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        ASSERT_EQ(elements[i].m_data, std::to_string(5000 + i));
+    }
+
+    ASSERT_NE(reader.read(SIZE, element), 0);
+    std::fclose(file);
+}
+
+} // namespace
+
+TEST(ListReaderTest, indexed)
+{
+    solution::SerializeOptions options;
+    options.index = true;
+    write_list(options);
+    check_reader(true);
+}
+
+TEST(ListReaderTest, not_indexed)
+{
+    write_list({});
+    check_reader(false);
+}
+
+TEST(ListReaderTest, dictionary)
+{
+    solution::SerializeOptions options;
+    options.dictionary = true;
+    write_list(options);
+    check_reader(false);
+    options.index = true;
+    write_list(options);
+    check_reader(true);
+}
+
+TEST(ListReaderTest, compressed)
+{
+    solution::SerializeOptions options;
+    options.compress = true;
+    write_list(options);
+    check_reader(false);
+    options.index = true;
+    write_list(options);
+    check_reader(true);
+}
+
+TEST(ListReaderTest, payload_size)
+{
+    solution::List list;
+    list.push_back("Hello");
+    list.push_back(", world!");
+
+    solution::SerializeOptions options;
+    options.index = true;
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::ListReader reader;
+    ASSERT_EQ(reader.open(file), 0);
+    ASSERT_EQ(reader.size(), 2);
+    ASSERT_EQ(reader.payload_size(), 13);
+    std::fclose(file);
+
+    // The index does not prevent the usual deserialization
+    file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    ASSERT_EQ(deserialized.size(), 2);
+    ASSERT_EQ(*std::next(deserialized.begin()), ", world!");
+}
+
+TEST(ListReaderTest, corrupted_sizes)
+{
+    // A header and a dictionary section that declares 2^52 bytes of entries
+    solution::SerializeOptions options;
+    options.dictionary = true;
+    write_list(options);
+    auto * file = std::fopen("buffer", "rb");
+    char data[solution::format::HEADER_SIZE + solution::format::DICTIONARY_HEADER_SIZE];
+    ASSERT_EQ(std::fread(data, sizeof(char), sizeof(data), file), sizeof(data));
+    std::fclose(file);
+    solution::format::put_u64(data + solution::format::HEADER_SIZE + 8, std::uint64_t{1} << 52);
+    file = std::fopen("buffer", "wb");
+    std::fwrite(data, sizeof(char), sizeof(data), file);
+    std::fclose(file);
+    file = std::fopen("buffer", "rb");
+    solution::ListReader reader;
+    ASSERT_EQ(reader.open(file), 1);
+    std::fclose(file);
+
+    // The index declares more frames than the file holds
+    solution::List list;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        list.push_back(std::to_string(i));
+    }
+    file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, {solution::format::VERSION_2, true}), 0);
+    const auto size = std::ftell(file);
+    std::fclose(file);
+    std::vector<char> bytes(static_cast<std::size_t>(size));
+    file = std::fopen("buffer", "rb");
+    ASSERT_EQ(std::fread(bytes.data(), sizeof(char), bytes.size(), file), bytes.size());
+    std::fclose(file);
+    const auto index = solution::format::get_integer<std::uint64_t>(bytes.data() + bytes.size() - solution::format::FOOTER_SIZE);
+    solution::format::put_u64(bytes.data() + index, 999);
+    file = std::fopen("buffer", "wb");
+    std::fwrite(bytes.data(), sizeof(char), bytes.size(), file);
+    std::fclose(file);
+    file = std::fopen("buffer", "rb");
+    ASSERT_EQ(reader.open(file), 1);
+    std::fclose(file);
+}
+
+TEST(ListReaderTest, legacy_format)
+{
+    solution::List list;
+    list.push_back("1");
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, {solution::format::VERSION_1}), 0);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::ListReader reader;
+    ASSERT_NE(reader.open(file), 0);
+    std::fclose(file);
+}
+
+} // namespace test
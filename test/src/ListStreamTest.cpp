@@ -0,0 +1,178 @@
+#include "ListStream.h"
+#include "Serialization.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+constexpr std::size_t SIZE = 100000;
+
+/**
+ * Serializes the list {"0", "1", ...} where every third element is linked with the first one.
+ */
+void write_list(const solution::SerializeOptions & options)
+{
+    solution::List list;
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        auto it = list.push_back(std::to_string(i));
+        if (i % 3 == 0) {
+            it.link(list.begin());
+        }
+    }
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+}
+
+std::uint64_t expected_random(std::size_t index)
+{
+    return index % 3 == 0 ? 0 : solution::ListStream::NO_RANDOM;
+}
+
+} // namespace
+
+TEST(ListStreamTest, callback)
+{
+    solution::SerializeOptions compressed;
+    compressed.compress = true;
+    for (const auto & options : {solution::SerializeOptions{solution::format::VERSION_1}, solution::SerializeOptions{}, compressed}) {
+        write_list(options);
+        const auto version = options.version;
+
+        auto * file = std::fopen("buffer", "rb");
+        solution::ListStream stream;
+        ASSERT_EQ(stream.open(file), 0);
+        ASSERT_EQ(stream.size(), version == solution::format::VERSION_1 ? solution::ListStream::UNKNOWN_SIZE : SIZE);
+        std::size_t index = 0;
+        ASSERT_EQ(stream.for_each([&](std::string_view data, std::uint64_t random) {
+            ASSERT_EQ(data, std::to_string(index));
+            ASSERT_EQ(random, expected_random(index));
+            ++index;
+        }),
+                  0);
+        ASSERT_EQ(index, SIZE);
+        std::fclose(file);
+    }
+}
+
+TEST(ListStreamTest, dictionary)
+{
+    solution::List list;
+    for (const std::string_view value : {"on", "off", "on", "on"}) {
+        list.push_back(value);
+    }
+    solution::SerializeOptions options;
+    options.dictionary = true;
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::ListStream stream;
+    ASSERT_EQ(stream.open(file), 0);
+    std::vector<std::string> data;
+    ASSERT_EQ(stream.for_each([&data](std::string_view value, std::uint64_t) { data.emplace_back(value); }), 0);
+    ASSERT_EQ(data, (std::vector<std::string>{"on", "off", "on", "on"}));
+    std::fclose(file);
+}
+
+TEST(ListStreamTest, iterator)
+{
+    write_list({});
+
+    const auto fd = open("buffer", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    solution::ListStream stream;
+    ASSERT_EQ(stream.open(fd), 0);
+    std::size_t index = 0;
+    for (const auto & element : stream) {
+        ASSERT_EQ(element.m_data, std::to_string(index));
+        ASSERT_EQ(element.m_random, expected_random(index));
+        ++index;
+    }
+    ASSERT_EQ(index, SIZE);
+    ASSERT_EQ(stream.status(), 0);
+    close(fd);
+}
+
+TEST(ListStreamTest, following_data)
+{
+    solution::List list;
+    list.push_back("1");
+    list.push_back("2");
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file), 0);
+    std::fputs("tail", file);
+    std::fclose(file);
+
+    // The bytes after the list are left in the file
+    file = std::fopen("buffer", "rb");
+    {
+        solution::ListStream stream;
+        ASSERT_EQ(stream.open(file), 0);
+        solution::ListStream::Element element;
+        ASSERT_TRUE(stream.next(element));
+        ASSERT_EQ(element.m_data, "1");
+        ASSERT_TRUE(stream.next(element));
+        ASSERT_EQ(element.m_data, "2");
+        ASSERT_FALSE(stream.next(element));
+        ASSERT_EQ(stream.status(), 0);
+    }
+    char tail[5] = {};
+    ASSERT_EQ(std::fread(tail, sizeof(char), 4, file), 4);
+    ASSERT_STREQ(tail, "tail");
+    std::fclose(file);
+}
+
+TEST(ListStreamTest, truncated)
+{
+    write_list({});
+    auto * file = std::fopen("buffer", "rb");
+    std::vector<char> data(1000);
+    ASSERT_EQ(std::fread(data.data(), sizeof(char), data.size(), file), data.size());
+    std::fclose(file);
+
+    file = std::fopen("buffer", "wb");
+    std::fwrite(data.data(), sizeof(char), data.size(), file);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::ListStream stream;
+    ASSERT_EQ(stream.open(file), 0);
+    ASSERT_NE(stream.for_each([](std::string_view, std::uint64_t) {}), 0);
+    std::fclose(file);
+}
+
+TEST(ListStreamTest, corrupted_sizes)
+{
+    // A header and a dictionary section that declares 2^52 bytes of entries
+    solution::SerializeOptions options;
+    options.dictionary = true;
+    write_list(options);
+    auto * file = std::fopen("buffer", "rb");
+    char data[solution::format::HEADER_SIZE + solution::format::DICTIONARY_HEADER_SIZE];
+    ASSERT_EQ(std::fread(data, sizeof(char), sizeof(data), file), sizeof(data));
+    std::fclose(file);
+    solution::format::put_u64(data + solution::format::HEADER_SIZE + 8, std::uint64_t{1} << 52);
+
+    solution::io::MemorySource source(data, sizeof(data));
+    solution::ListStream stream;
+    ASSERT_EQ(stream.open(source), 1);
+
+    // The size of a pipe is unknown, the entries are read until the data ends
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::write(fds[1], data, sizeof(data)), static_cast<ssize_t>(sizeof(data)));
+    ::close(fds[1]);
+    ASSERT_EQ(stream.open(fds[0]), 1);
+    ::close(fds[0]);
+}
+
+} // namespace test
@@ -0,0 +1,126 @@
+#include "ListView.h"
+#include "Serialization.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+void write_list(solution::List & list, bool index, bool dictionary = false)
+{
+    solution::SerializeOptions options;
+    options.index = index;
+    options.dictionary = dictionary;
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+}
+
+int open_view(solution::ListView & view)
+{
+    auto * file = std::fopen("buffer", "rb");
+    const auto status = view.open(file);
+    std::fclose(file);
+    return status;
+}
+
+} // namespace
+
+TEST(ListViewTest, iteration)
+{
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        nodes.push_back(list.push_back(std::string(i % 100, 'a' + i % 26)));
+    }
+    for (std::size_t i = 0; i < nodes.size(); i += 3) {
+        nodes[i].link(nodes[(i * 7919) % nodes.size()]);
+    }
+    write_list(list, true);
+
+    solution::ListView view;
+    ASSERT_EQ(open_view(view), 0);
+    ASSERT_EQ(view.size(), list.size());
+
+    auto it = view.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_NE(it, view.end());
+        ASSERT_EQ(*it, *jt);
+        ASSERT_EQ(it->size(), jt->size());
+        ASSERT_EQ(it.next() == view.end(), jt.next() == list.end());
+        ASSERT_EQ(*it.next(), *jt.next());
+    }
+    ASSERT_EQ(it, view.end());
+    ASSERT_EQ(*std::prev(it), *std::prev(list.end()));
+}
+
+TEST(ListViewTest, dictionary)
+{
+    solution::List list;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        list.push_back(std::to_string(i % 10)).link(list.begin());
+    }
+    write_list(list, true, true);
+
+    solution::ListView view;
+    ASSERT_EQ(open_view(view), 0);
+    ASSERT_EQ(view.size(), list.size());
+    ASSERT_EQ(*view.at(12345), "5");
+    ASSERT_EQ(*view.at(12345).next(), "0");
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), list.begin(), list.end()));
+}
+
+TEST(ListViewTest, random_order)
+{
+    solution::List list;
+    for (const std::string_view value : {"1", "2", "3", "4"}) {
+        list.push_back(value);
+    }
+    auto first = list.begin();
+    auto second = std::next(first);
+    auto third = std::next(second);
+    auto fourth = std::next(third);
+    first.link(fourth);
+    second.link(third);
+    fourth.link(second);
+    write_list(list, true);
+
+    solution::ListView view;
+    ASSERT_EQ(open_view(view), 0);
+    auto it = view.begin();
+    ASSERT_EQ(*it, "1");
+    ASSERT_EQ(*(it.move()), "4");
+    ASSERT_EQ(*(it.move()), "2");
+    ASSERT_EQ(*(it.move()), "3");
+    ASSERT_EQ(it.move(), view.end());
+    ASSERT_EQ(*std::prev(it), "4");
+}
+
+TEST(ListViewTest, empty)
+{
+    solution::List list;
+    write_list(list, true);
+
+    solution::ListView view;
+    ASSERT_EQ(open_view(view), 0);
+    ASSERT_TRUE(view.empty());
+    ASSERT_EQ(view.begin(), view.end());
+}
+
+TEST(ListViewTest, requires_index)
+{
+    solution::List list;
+    list.push_back("1");
+    write_list(list, false);
+
+    solution::ListView view;
+    ASSERT_NE(open_view(view), 0);
+    ASSERT_TRUE(view.empty());
+    ASSERT_NE(view.open(nullptr), 0);
+}
+
+} // namespace test
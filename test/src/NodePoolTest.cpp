@@ -0,0 +1,107 @@
+#include "NodePool.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace test {
+
+TEST(NodePoolTest, reuse)
+{
+    solution::NodePool<std::string> pool;
+
+    auto * first = pool.create("first");
+    auto * second = pool.create("second");
+    ASSERT_EQ(*first, "first");
+    ASSERT_EQ(*second, "second");
+
+    pool.destroy(first);
+    auto * third = pool.create("third");
+    ASSERT_EQ(third, first);
+    ASSERT_EQ(*third, "third");
+
+    pool.destroy(second);
+    pool.destroy(third);
+}
+
+TEST(NodePoolTest, contiguous)
+{
+    solution::NodePool<std::size_t> pool;
+
+    auto * previous = pool.create(0);
+    for (std::size_t i = 1; i < 32; ++i) {
+        auto * current = pool.create(i);
+        ASSERT_EQ(current, previous + 1);
+        previous = current;
+    }
+}
+
+TEST(NodePoolTest, slot)
+{
+    solution::NodePool<std::size_t> pool;
+
+    std::vector<std::size_t *> objects;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        objects.push_back(pool.create(i));
+    }
+    std::vector<bool> used(pool.capacity());
+    for (const auto * object : objects) {
+        const auto slot = pool.slot(object);
+        ASSERT_LT(slot, pool.capacity());
+        ASSERT_FALSE(used[slot]);
+        used[slot] = true;
+    }
+
+    const auto slot = pool.slot(objects[42]);
+    pool.destroy(objects[42]);
+    ASSERT_EQ(pool.slot(pool.create(0)), slot);
+}
+
+TEST(NodePoolTest, release)
+{
+    solution::NodePool<std::size_t> pool;
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        pool.create(i);
+    }
+    ASSERT_GE(pool.capacity(), 1000);
+
+    pool.release();
+    ASSERT_EQ(pool.capacity(), 0);
+
+    ASSERT_EQ(*pool.create(42), 42);
+    ASSERT_GT(pool.capacity(), 0);
+}
+
+TEST(NodePoolTest, merge)
+{
+    solution::NodePool<std::size_t> pool;
+    solution::NodePool<std::size_t> other;
+    std::vector<std::size_t *> objects;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        objects.push_back(pool.create(i));
+        objects.push_back(other.create(i + 1000));
+    }
+    const auto capacity = pool.capacity() + other.capacity();
+
+    pool.merge(std::move(other));
+    ASSERT_EQ(other.capacity(), 0);
+    ASSERT_EQ(pool.capacity(), capacity);
+    // Objects stay in place and get distinct slots
+    std::vector<bool> used(pool.capacity());
+    for (const auto * object : objects) {
+        const auto slot = pool.slot(object);
+        ASSERT_EQ(pool.at(slot), object);
+        ASSERT_FALSE(used[slot]);
+        used[slot] = true;
+    }
+    for (std::size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(*objects[2 * i], i);
+        ASSERT_EQ(*objects[2 * i + 1], i + 1000);
+    }
+    auto * created = pool.create(42);
+    ASSERT_EQ(pool.at(pool.slot(created)), created);
+    ASSERT_EQ(*other.create(7), 7);
+}
+
+} // namespace test
@@ -0,0 +1,79 @@
+#include "OrderIndex.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+void expect_equal(const solution::OrderIndex & index, const std::vector<std::size_t> & expected)
+{
+    ASSERT_EQ(index.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(index.at(i), expected[i]);
+        ASSERT_EQ(index.position(expected[i]), i);
+    }
+}
+
+} // namespace
+
+TEST(OrderIndexTest, assign)
+{
+    solution::OrderIndex index;
+    ASSERT_EQ(index.size(), 0);
+    std::vector<std::size_t> ids(1000);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = (i * 7) % ids.size();
+    }
+    index.assign(ids);
+    expect_equal(index, ids);
+    index.clear();
+    ASSERT_EQ(index.size(), 0);
+}
+
+TEST(OrderIndexTest, random_operations)
+{
+    std::mt19937 generator(42);
+    solution::OrderIndex index;
+    std::vector<std::size_t> expected;
+    std::vector<std::size_t> free;
+    std::size_t next = 0;
+    for (int step = 0; step < 20000; ++step) {
+        const auto operation = generator() % 10;
+        if (operation < 6 || expected.empty()) {
+            std::size_t id;
+            if (free.empty()) {
+                id = next++;
+            }
+            else {
+                id = free.back();
+                free.pop_back();
+            }
+            const auto position = generator() % (expected.size() + 1);
+            index.insert(position, id);
+            expected.insert(expected.begin() + static_cast<long>(position), id);
+        }
+        else if (operation < 9) {
+            const auto position = generator() % expected.size();
+            index.erase(expected[position]);
+            free.push_back(expected[position]);
+            expected.erase(expected.begin() + static_cast<long>(position));
+        }
+        else {
+            const auto first = generator() % expected.size();
+            const auto last = first + generator() % (std::min<std::size_t>(expected.size() - first, 50) + 1);
+            index.erase(first, last);
+            free.insert(free.end(), expected.begin() + static_cast<long>(first), expected.begin() + static_cast<long>(last));
+            expected.erase(expected.begin() + static_cast<long>(first), expected.begin() + static_cast<long>(last));
+        }
+        if (step % 1000 == 0) {
+            expect_equal(index, expected);
+        }
+    }
+    expect_equal(index, expected);
+}
+
+} // namespace test
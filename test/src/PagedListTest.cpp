@@ -0,0 +1,219 @@
+#include "PagedList.h"
+
+#include "Serialization.h"
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+constexpr auto FILE_NAME = "paged_buffer";
+
+void remove_files()
+{
+    std::remove(FILE_NAME);
+    std::remove((std::string(FILE_NAME) + ".payloads").c_str());
+    std::remove((std::string(FILE_NAME) + ".positions").c_str());
+}
+
+std::vector<std::string> elements(solution::PagedList & list)
+{
+    return {list.begin(), list.end()};
+}
+
+} // namespace
+
+TEST(PagedListTest, modification)
+{
+    remove_files();
+    solution::PagedList list;
+    ASSERT_EQ(list.open(FILE_NAME, solution::PagedList::PAGE_SIZE - 1), -1);
+    ASSERT_EQ(list.open(FILE_NAME), 0);
+    ASSERT_TRUE(list.empty());
+    list.push_back("2");
+    list.push_front("1");
+    const auto fourth = list.push_back("4");
+    const auto third = list.insert(fourth, "3");
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"1", "2", "3", "4"}));
+    ASSERT_EQ(*std::prev(list.end()), "4");
+
+    list.begin().link(third);
+    third.link(list.begin());
+    ASSERT_EQ(*list.begin().next(), "3");
+    ASSERT_EQ(*list.begin().next().next(), "1");
+    ASSERT_EQ(fourth.next(), list.end());
+
+    ASSERT_EQ(*list.erase(std::next(list.begin())), "3");
+    list.pop_back();
+    list.pop_front();
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"3"}));
+    // Erased nodes are reused
+    list.push_back(std::string(3 * solution::PagedList::PAGE_SIZE, 'x'));
+    ASSERT_EQ(elements(list), (std::vector<std::string>{"3", std::string(3 * solution::PagedList::PAGE_SIZE, 'x')}));
+
+    list.clear();
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.begin(), list.end());
+    ASSERT_EQ(list.close(), 0);
+    remove_files();
+}
+
+TEST(PagedListTest, eviction)
+{
+    remove_files();
+    std::mt19937 generator(42);
+    std::vector<std::string> expected;
+    {
+        // Two pages of the cache for several hundreds of pages of data
+        solution::PagedList list;
+        ASSERT_EQ(list.open(FILE_NAME, 2 * solution::PagedList::PAGE_SIZE), 0);
+        std::vector<solution::PagedList::Iterator> nodes;
+        for (std::size_t i = 0; i < 20000; ++i) {
+            auto data = std::to_string(i) + std::string(generator() % 2000, static_cast<char>('a' + i % 26));
+            if (generator() % 2) {
+                list.push_back(data);
+                expected.push_back(std::move(data));
+            }
+            else {
+                list.push_front(data);
+                expected.insert(expected.begin(), std::move(data));
+            }
+        }
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            nodes.push_back(it);
+        }
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i].link(nodes[(i * 7 + 3) % nodes.size()]);
+        }
+        for (std::size_t i = 0; i < 5000; ++i) {
+            const auto position = generator() % nodes.size();
+            ASSERT_EQ(*nodes[position], expected[position]);
+            ASSERT_EQ(*nodes[position].next(), expected[(position * 7 + 3) % nodes.size()]);
+        }
+        ASSERT_EQ(elements(list), expected);
+        ASSERT_EQ(list.status(), 0);
+    }
+    // The files keep the list after the destructor flushes it
+    solution::PagedList list;
+    ASSERT_EQ(list.open(FILE_NAME, 4 * solution::PagedList::PAGE_SIZE), 0);
+    ASSERT_EQ(list.size(), expected.size());
+    ASSERT_EQ(elements(list), expected);
+    ASSERT_EQ(*std::next(list.begin(), 10).next(), expected[73]);
+    ASSERT_EQ(*std::prev(list.end()), expected.back());
+    ASSERT_EQ(list.close(), 0);
+    remove_files();
+}
+
+TEST(PagedListTest, serialization)
+{
+    remove_files();
+    solution::List original;
+    std::vector<solution::List::Iterator> nodes;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        nodes.push_back(original.push_back(std::string(i % 100, static_cast<char>('a' + i % 26))));
+    }
+    for (std::size_t i = 0; i < nodes.size(); i += 2) {
+        nodes[i].link(nodes[(i * 13) % nodes.size()]);
+    }
+    std::vector<char> v1;
+    solution::io::BufferSink v1_sink(v1);
+    ASSERT_EQ(original.serialize(v1_sink, {solution::format::VERSION_1}), 0);
+    std::vector<char> v2;
+    solution::io::BufferSink v2_sink(v2);
+    ASSERT_EQ(original.serialize(v2_sink), 0);
+
+    solution::PagedList list;
+    ASSERT_EQ(list.open(FILE_NAME, 2 * solution::PagedList::PAGE_SIZE), 0);
+    for (const auto * buffer : {&v1, &v2}) {
+        list.push_back("stale");
+        solution::io::MemorySource source(buffer->data(), buffer->size());
+        ASSERT_EQ(list.deserialize(source), 0);
+        ASSERT_EQ(list.size(), original.size());
+        // The paged list is written back without re-encoding it in memory
+        std::vector<char> written;
+        solution::io::BufferSink sink(written);
+        ASSERT_EQ(list.serialize(sink), 0);
+        ASSERT_EQ(written, v1);
+    }
+
+    // The "random" index is out of range
+    auto corrupted = v1;
+    corrupted[corrupted.size() - 8] = 1;
+    corrupted[corrupted.size() - 1] = 0;
+    solution::io::MemorySource source(corrupted.data(), corrupted.size());
+    ASSERT_NE(list.deserialize(source), 0);
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.close(), 0);
+    remove_files();
+}
+
+TEST(PagedListTest, clean_serialization)
+{
+    remove_files();
+    solution::PagedList list;
+    // Pages are evicted while the list is serialized
+    ASSERT_EQ(list.open(FILE_NAME, 4 * solution::PagedList::PAGE_SIZE), 0);
+    for (std::size_t i = 0; i < 5000; ++i) {
+        list.push_back(std::to_string(i));
+    }
+    list.begin().link(std::prev(list.end()));
+    ASSERT_EQ(list.flush(), 0);
+
+    // Records do not fill the end of a page, a page written back would overwrite the marker there
+    const auto pages = std::size_t{5000} * 40 / solution::PagedList::PAGE_SIZE + 1;
+    const auto marker_offset = [](const std::size_t page) {
+        return static_cast<long>((page + 2) * solution::PagedList::PAGE_SIZE - 1);
+    };
+    const auto mark = [&] {
+        auto * file = std::fopen(FILE_NAME, "r+b");
+        for (std::size_t page = 0; page < pages; ++page) {
+            std::fseek(file, marker_offset(page), SEEK_SET);
+            std::fputc('M', file);
+        }
+        std::fclose(file);
+    };
+    const auto expect_marked = [&] {
+        auto * file = std::fopen(FILE_NAME, "rb");
+        for (std::size_t page = 0; page < pages; ++page) {
+            std::fseek(file, marker_offset(page), SEEK_SET);
+            EXPECT_EQ(std::fgetc(file), 'M');
+        }
+        std::fclose(file);
+    };
+
+    // Neither numbering the nodes after a change nor serializing them again writes pages of nodes
+    std::vector<char> first;
+    std::vector<char> second;
+    for (auto * buffer : {&first, &second}) {
+        mark();
+        solution::io::BufferSink sink(*buffer);
+        ASSERT_EQ(list.serialize(sink), 0);
+        ASSERT_EQ(list.flush(), 0);
+        expect_marked();
+    }
+    ASSERT_EQ(second, first);
+
+    list.pop_front();
+    ASSERT_EQ(list.flush(), 0);
+    mark();
+    std::vector<char> third;
+    solution::io::BufferSink sink(third);
+    ASSERT_EQ(list.serialize(sink), 0);
+    ASSERT_EQ(list.flush(), 0);
+    expect_marked();
+    solution::List deserialized;
+    solution::io::MemorySource source(third.data(), third.size());
+    ASSERT_EQ(deserialized.deserialize(source), 0);
+    ASSERT_EQ(deserialized.size(), 4999);
+    ASSERT_EQ(*deserialized.begin(), "1");
+    ASSERT_EQ(list.close(), 0);
+    remove_files();
+}
+
+} // namespace test
@@ -0,0 +1,93 @@
+#include "PayloadArena.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace test {
+
+TEST(PayloadArenaTest, store)
+{
+    solution::PayloadArena arena;
+
+    std::string data = "Hello, world!";
+    const auto stored = arena.store(data);
+    data[0] = 'J';
+
+    ASSERT_EQ(stored, "Hello, world!");
+    ASSERT_NE(stored.data(), data.data());
+    ASSERT_EQ(arena.size(), data.size());
+    ASSERT_TRUE(arena.store("").empty());
+}
+
+TEST(PayloadArenaTest, stability)
+{
+    solution::PayloadArena arena;
+
+    const std::string large(1 << 20, 'x');
+    const auto first = arena.store("first");
+    const auto huge = arena.store(large);
+    std::vector<std::string_view> views;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        views.push_back(arena.store(std::to_string(i)));
+    }
+
+    ASSERT_EQ(first, "first");
+    ASSERT_EQ(huge, large);
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        ASSERT_EQ(views[i], std::to_string(i));
+    }
+
+    arena.release();
+    ASSERT_EQ(arena.size(), 0);
+}
+
+TEST(PayloadArenaTest, move_and_merge)
+{
+    solution::PayloadArena arena;
+    const auto first = arena.store("first");
+
+    solution::PayloadArena moved(std::move(arena));
+    ASSERT_EQ(arena.size(), 0);
+    // The moved-from arena does not write into the slabs it gave away
+    const auto second = arena.store("second");
+    const auto third = moved.store("third");
+    ASSERT_EQ(first, "first");
+    ASSERT_EQ(second, "second");
+    ASSERT_EQ(third, "third");
+
+    moved.merge(std::move(arena));
+    ASSERT_EQ(arena.size(), 0);
+    ASSERT_EQ(moved.size(), 16);
+    ASSERT_EQ(moved.store("fourth"), "fourth");
+    ASSERT_EQ(second, "second");
+    ASSERT_EQ(arena.store("fifth"), "fifth");
+    ASSERT_EQ(first, "first");
+}
+
+TEST(PayloadArenaTest, garbage)
+{
+    solution::PayloadArena arena;
+    const auto first = arena.store("first");
+    const auto second = arena.store("second");
+    ASSERT_FALSE(arena.wasteful(2));
+
+    arena.discard(first);
+    ASSERT_EQ(arena.garbage(), 5);
+    ASSERT_FALSE(arena.wasteful(1));
+    arena.discard(second);
+    ASSERT_TRUE(arena.wasteful(0));
+    // Discarding a few bytes does not pay off for many live payloads
+    ASSERT_FALSE(arena.wasteful(100));
+
+    solution::PayloadArena other;
+    other.discard(other.store("third"));
+    arena.merge(std::move(other));
+    ASSERT_EQ(arena.garbage(), 16);
+    ASSERT_EQ(other.garbage(), 0);
+
+    arena.release();
+    ASSERT_EQ(arena.garbage(), 0);
+}
+
+} // namespace test
@@ -1,10 +1,55 @@
 #include "RemovingDuplicates.h"
 
+#include <cstdio>
 #include <cstring>
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace test {
 
+namespace {
+
+constexpr solution::DuplicatesKernel KERNELS[] = {
+        solution::DuplicatesKernel::PORTABLE,
+        solution::DuplicatesKernel::SSSE3,
+        solution::DuplicatesKernel::AVX2,
+        solution::DuplicatesKernel::AVX512,
+        solution::DuplicatesKernel::NEON};
+
+/**
+ * @return the string without consecutive duplicates.
+ */
+std::string expected(const std::string & str)
+{
+    std::string result;
+    for (const auto c : str) {
+        if (result.empty() || result.back() != c) {
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+/**
+ * @return a string with runs of up to several megabytes, null characters included.
+ */
+std::string long_runs(const std::size_t size)
+{
+    std::mt19937 generator(42);
+    std::string str;
+    while (str.size() < size) {
+        const auto length = generator() % 4 == 0 ? generator() % (3 << 20) : generator() % 5 + 1;
+        str.append(length, static_cast<char>(generator() % 3));
+    }
+    return str;
+}
+
+} // namespace
+
 TEST(RemovingDuplicatesTest, empty)
 {
     {
@@ -37,4 +82,221 @@ TEST(RemovingDuplicatesTest, sample)
     }
 }
 
+TEST(RemovingDuplicatesTest, kernels)
+{
+    // Runs of a small alphabet of random lengths at every offset from the alignment of blocks
+    std::mt19937 generator(42);
+    for (const auto kernel : KERNELS) {
+        for (std::size_t i = 0; i < 2000; ++i) {
+            std::string str;
+            const auto length = generator() % 300;
+            while (str.size() < length) {
+                str.append(generator() % (i % 2 == 0 ? 3 : 40) + 1, static_cast<char>('a' + generator() % 3));
+            }
+            const auto offset = i % 64;
+            alignas(64) char data[512 + 64];
+            std::memcpy(data + offset, str.c_str(), str.size() + 1);
+            if (!solution::remove_duplicates(data + offset, kernel)) {
+                break;
+            }
+            ASSERT_EQ(data + offset, expected(str)) << static_cast<int>(kernel) << ' ' << str;
+        }
+    }
+}
+
+TEST(RemovingDuplicatesTest, page_boundary)
+{
+    // The null character is the last byte before a page that cannot be read
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto * pages = static_cast<char *>(::mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(pages, MAP_FAILED);
+    ASSERT_EQ(::mprotect(pages + page, page, PROT_NONE), 0);
+    for (const auto kernel : KERNELS) {
+        for (std::size_t length = 0; length < 200; ++length) {
+            std::string str;
+            for (std::size_t i = 0; i < length; ++i) {
+                str.push_back(static_cast<char>('a' + i / 3 % 2));
+            }
+            auto * data = pages + page - length - 1;
+            std::memcpy(data, str.c_str(), length + 1);
+            if (!solution::remove_duplicates(data, kernel)) {
+                break;
+            }
+            ASSERT_EQ(data, expected(str)) << static_cast<int>(kernel);
+            // A buffer of the given length ends right before the page
+            ++data;
+            std::memcpy(data, str.data(), length);
+            auto size = length;
+            ASSERT_TRUE(solution::remove_duplicates(data, size, kernel));
+            ASSERT_EQ(std::string(data, size), expected(str)) << static_cast<int>(kernel);
+        }
+    }
+    ::munmap(pages, 2 * page);
+}
+
+TEST(RemovingDuplicatesTest, length)
+{
+    // Null characters are ordinary ones, the bytes after the buffer are not changed
+    std::mt19937 generator(7);
+    for (const auto kernel : KERNELS) {
+        for (std::size_t i = 0; i < 2000; ++i) {
+            std::string str;
+            const auto length = generator() % 300;
+            while (str.size() < length) {
+                str.append(generator() % (i % 2 == 0 ? 3 : 40) + 1, static_cast<char>(generator() % 3));
+            }
+            str.resize(length);
+            const auto offset = i % 64;
+            alignas(64) char data[300 + 64 + 1];
+            std::memcpy(data + offset, str.data(), length);
+            data[offset + length] = 'x';
+            auto size = length;
+            if (!solution::remove_duplicates(data + offset, size, kernel)) {
+                break;
+            }
+            ASSERT_EQ(std::string(data + offset, size), expected(str)) << static_cast<int>(kernel);
+            ASSERT_EQ(data[offset + length], 'x');
+        }
+    }
+    char data[] = "AAA BBB AAA";
+    ASSERT_EQ(solution::remove_duplicates(data, 0), 0);
+    ASSERT_EQ(solution::remove_duplicates(data, 5), 3);
+    EXPECT_EQ(std::strcmp(data, "A B BBB AAA"), 0);
+}
+
+TEST(RemovingDuplicatesTest, parallel)
+{
+    // Runs of up to several megabytes span whole chunks
+    const auto str = long_runs(std::size_t{12} << 20);
+    const auto result = expected(str);
+    const std::string single(std::size_t{5} << 20, 'a');
+    for (const std::size_t threads : {0, 1, 2, 3, 8}) {
+        auto data = str;
+        data.resize(solution::remove_duplicates_parallel(data.data(), data.size(), threads));
+        ASSERT_EQ(data, result) << threads;
+        data = single;
+        ASSERT_EQ(solution::remove_duplicates_parallel(data.data(), data.size(), threads), 1);
+        ASSERT_EQ(data[0], 'a');
+    }
+    char data[] = "AAA BBB AAA";
+    ASSERT_EQ(solution::remove_duplicates_parallel(data, 11), 5);
+}
+
+TEST(RemovingDuplicatesTest, filter)
+{
+    // Runs continue over blocks of random lengths, including empty ones
+    std::mt19937 generator(1);
+    std::string str;
+    while (str.size() < 100000) {
+        str.append(generator() % 2 == 0 ? generator() % 1000 + 1 : 1, static_cast<char>('a' + generator() % 2));
+    }
+    solution::DuplicatesFilter filter;
+    std::string result;
+    std::vector<char> out(str.size());
+    for (std::size_t position = 0; position < str.size();) {
+        const auto length = std::min<std::size_t>(generator() % 3000, str.size() - position);
+        result += filter.filter(str.data() + position, length, out.data());
+        position += length;
+    }
+    ASSERT_EQ(result, expected(str));
+    filter.reset();
+    ASSERT_EQ(filter.filter(str.data(), 1, out.data()), str.substr(0, 1));
+}
+
+TEST(RemovingDuplicatesTest, stream)
+{
+    const auto str = long_runs(std::size_t{5} << 20);
+    const auto result = expected(str);
+    {
+        solution::io::MemorySource source(str);
+        std::vector<char> buffer;
+        solution::io::BufferSink sink(buffer);
+        ASSERT_EQ(solution::remove_duplicates(source, sink), 0);
+        ASSERT_EQ(std::string(buffer.begin(), buffer.end()), result);
+    }
+
+    // Mapped regular files are read from the current offset, which need not be aligned
+    auto * input = std::tmpfile();
+    auto * output = std::tmpfile();
+    ASSERT_EQ(std::fwrite(str.data(), 1, str.size(), input), str.size());
+    ASSERT_EQ(std::fflush(input), 0);
+    const auto offset = 5001;
+    ASSERT_EQ(::lseek(fileno(input), offset, SEEK_SET), offset);
+    ASSERT_EQ(solution::remove_duplicates(fileno(input), fileno(output)), 0);
+    ASSERT_EQ(::lseek(fileno(input), 0, SEEK_CUR), static_cast<off_t>(str.size()));
+    const auto tail = expected(str.substr(offset));
+    std::string written(tail.size() + 1, '\0');
+    ASSERT_EQ(::pread(fileno(output), written.data(), written.size(), 0), static_cast<ssize_t>(tail.size()));
+    written.pop_back();
+    ASSERT_EQ(written, tail);
+
+    std::rewind(input);
+    std::rewind(output);
+    ASSERT_EQ(solution::remove_duplicates(input, output), 0);
+    ASSERT_EQ(std::fflush(output), 0);
+    written.assign(result.size(), '\0');
+    ASSERT_EQ(::pread(fileno(output), written.data(), written.size(), 0), static_cast<ssize_t>(result.size()));
+    ASSERT_EQ(written, result);
+    std::fclose(input);
+    std::fclose(output);
+    ASSERT_EQ(solution::remove_duplicates(nullptr, nullptr), -1);
+    ASSERT_EQ(solution::remove_duplicates(-1, 1), -1);
+
+    // Pipes are read by blocks
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::write(fds[1], "AAA BBB AAA", 11), 11);
+    ::close(fds[1]);
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    ASSERT_EQ(solution::remove_duplicates(fds[0], sink), 0);
+    ::close(fds[0]);
+    ASSERT_EQ(std::string(buffer.begin(), buffer.end()), "A B A");
+}
+
+TEST(RemovingDuplicatesTest, batch)
+{
+    // Mostly short strings, a few long ones and empty ones
+    std::mt19937 generator(3);
+    std::vector<std::string> strings(100000);
+    for (auto & str : strings) {
+        const auto length = generator() % 100 == 0 ? generator() % 10000 : generator() % 40;
+        while (str.size() < length) {
+            str.append(generator() % 3 + 1, static_cast<char>(generator() % 3));
+        }
+    }
+    std::vector<std::size_t> offsets{0};
+    std::string packed;
+    for (const auto & str : strings) {
+        packed += str;
+        offsets.push_back(packed.size());
+    }
+    for (const std::size_t threads : {0, 1, 3}) {
+        auto batch = strings;
+        std::vector<char *> pointers;
+        std::vector<std::size_t> lengths;
+        for (auto & str : batch) {
+            pointers.push_back(str.data());
+            lengths.push_back(str.size());
+        }
+        solution::remove_duplicates_batch(pointers.data(), lengths.data(), batch.size(), threads);
+        auto buffer = packed;
+        std::vector<std::size_t> packed_lengths(strings.size());
+        solution::remove_duplicates_batch(buffer.data(), offsets.data(), strings.size(), packed_lengths.data(), threads);
+        for (std::size_t i = 0; i < strings.size(); ++i) {
+            ASSERT_EQ(batch[i].substr(0, lengths[i]), expected(strings[i])) << threads;
+            ASSERT_EQ(buffer.substr(offsets[i], packed_lengths[i]), expected(strings[i])) << threads;
+        }
+    }
+    solution::remove_duplicates_batch(nullptr, nullptr, 0);
+}
+
+TEST(RemovingDuplicatesTest, dispatch)
+{
+    // The kernel chosen at runtime is supported, so it can be run explicitly
+    char data[] = "AAA BBB AAA";
+    ASSERT_TRUE(solution::remove_duplicates(data, solution::remove_duplicates_kernel()));
+    EXPECT_EQ(std::strcmp(data, "A B A"), 0);
+}
+
 } // namespace test
@@ -0,0 +1,81 @@
+#include "SerializationFormat.h"
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace test {
+
+TEST(SerializationFormatTest, varint)
+{
+    for (const std::uint64_t value : {std::uint64_t{0},
+                                      std::uint64_t{1},
+                                      std::uint64_t{127},
+                                      std::uint64_t{128},
+                                      std::uint64_t{300},
+                                      std::uint64_t{1} << 35,
+                                      std::numeric_limits<std::uint64_t>::max()}) {
+        char buffer[solution::format::MAX_VARINT_SIZE];
+        const auto * end = solution::format::put_varint(buffer, value);
+        const char * in = buffer;
+        std::uint64_t decoded;
+        ASSERT_TRUE(solution::format::get_varint(in, end, decoded));
+        ASSERT_EQ(in, end);
+        ASSERT_EQ(decoded, value);
+        in = buffer;
+        ASSERT_FALSE(solution::format::get_varint(in, end - 1, decoded));
+    }
+}
+
+TEST(SerializationFormatTest, integers)
+{
+    char buffer[8];
+    solution::format::put_u32(buffer, 0x01020304);
+    ASSERT_EQ(buffer[0], 4);
+    ASSERT_EQ(buffer[3], 1);
+    ASSERT_EQ(solution::format::get_integer<std::uint32_t>(buffer), 0x01020304u);
+
+    solution::format::put_u64(buffer, 0xfedcba9876543210);
+    ASSERT_EQ(solution::format::get_integer<std::uint64_t>(buffer), 0xfedcba9876543210u);
+}
+
+TEST(SerializationFormatTest, frame)
+{
+    std::vector<char> frames;
+    solution::format::FrameEncoder encoder(frames);
+    encoder.add("first", 0);
+    encoder.add(std::string(1000, 'x'), 42);
+    ASSERT_EQ(encoder.flush(), 0);
+    ASSERT_TRUE(encoder.empty());
+
+    std::vector<char> output;
+    solution::io::BufferSink sink(output);
+    solution::format::Writer writer(sink);
+    writer.write(frames.data(), frames.size());
+    ASSERT_TRUE(writer.flush());
+    ASSERT_EQ(output, frames);
+
+    solution::io::MemorySource source(output.data(), output.size());
+    solution::format::Reader reader(source);
+    char header[solution::format::FRAME_HEADER_SIZE];
+    ASSERT_TRUE(reader.read(header, sizeof(header)));
+    const auto records = solution::format::get_integer<std::uint32_t>(header);
+    std::vector<char> body(solution::format::get_integer<std::uint32_t>(header + 4));
+    ASSERT_TRUE(reader.read(body.data(), body.size()));
+    ASSERT_EQ(reader.get(), EOF);
+
+    std::vector<std::pair<std::string, std::uint64_t>> decoded;
+    ASSERT_TRUE(solution::format::decode_frame({body.data(), body.size()}, records, [&](std::string_view data, std::uint64_t random) {
+        decoded.emplace_back(data, random);
+    }));
+    ASSERT_EQ(decoded.size(), 2);
+    ASSERT_EQ(decoded[0].first, "first");
+    ASSERT_EQ(decoded[0].second, 0);
+    ASSERT_EQ(decoded[1].first, std::string(1000, 'x'));
+    ASSERT_EQ(decoded[1].second, 42);
+
+    ASSERT_FALSE(solution::format::decode_frame({body.data(), body.size() - 1}, records, [](std::string_view, std::uint64_t) {}));
+}
+
+} // namespace test
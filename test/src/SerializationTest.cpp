@@ -1,6 +1,13 @@
 #include "Serialization.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
 
 namespace test {
 
@@ -62,6 +69,52 @@ TEST(SerializationTest, remove)
     ASSERT_EQ(list.size(), 0);
 }
 
+TEST(SerializationTest, assign)
+{
+    solution::List list;
+
+    list.push_back("1");
+    auto it = list.push_back("2");
+    list.push_back("3");
+
+    const std::string data = "This value is too long for the small string optimization";
+    ASSERT_EQ(*list.assign(it, data), data);
+    ASSERT_EQ(list.size(), 3);
+
+    it = list.begin();
+    ASSERT_EQ(*(it++), "1");
+    ASSERT_EQ(*(it++), data);
+    ASSERT_EQ(*(it++), "3");
+    ASSERT_EQ(it, list.end());
+}
+
+TEST(SerializationTest, churn)
+{
+    solution::List list;
+    const std::string data(1000, 'x');
+    list.push_back("first");
+    const auto first = list.begin();
+    const auto * stored = first->data();
+
+    for (std::size_t i = 0; i < 100000; ++i) {
+        list.push_back(data + std::to_string(i));
+        if (list.size() > 10) {
+            list.erase(std::next(list.begin()));
+        }
+        list.assign(first, i % 2 == 0 ? "even" : "odd");
+    }
+
+    ASSERT_EQ(list.size(), 10);
+    // Erased and replaced payloads are reclaimed, the live ones are moved
+    ASSERT_EQ(*first, "odd");
+    ASSERT_NE(first->data(), stored);
+    auto it = std::next(list.begin());
+    for (std::size_t i = 100000 - 9; i < 100000; ++i, ++it) {
+        ASSERT_EQ(*it, data + std::to_string(i));
+    }
+    ASSERT_EQ(it, list.end());
+}
+
 TEST(SerializationTest, end)
 {
     solution::List list;
@@ -140,6 +193,913 @@ TEST(SerializationTest, serialization)
     ASSERT_EQ(second.next(), first);
 }
 
+TEST(SerializationTest, legacy_format)
+{
+    solution::List list;
+    for (const std::string_view value : {"1", "2", "3"}) {
+        list.push_back(value);
+    }
+    std::prev(list.end()).link(list.begin());
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, {solution::format::VERSION_1}), 0);
+    std::fclose(file);
+
+    // Version 1 is a plain sequence of null-terminated strings and native indexes
+    file = std::fopen("buffer", "rb");
+    char data[2];
+    std::size_t random;
+    ASSERT_EQ(std::fread(data, sizeof(char), 2, file), 2);
+    ASSERT_EQ(std::string_view(data, 2), std::string_view("1\0", 2));
+    ASSERT_EQ(std::fread(&random, sizeof(random), 1, file), 1);
+    ASSERT_EQ(random, std::numeric_limits<std::size_t>::max());
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(deserialized.size(), 3);
+    auto it = deserialized.begin();
+    ASSERT_EQ(*(it++), "1");
+    ASSERT_EQ(*(it++), "2");
+    ASSERT_EQ(*it, "3");
+    ASSERT_EQ(it.next(), deserialized.begin());
+}
+
+TEST(SerializationTest, binary_payloads)
+{
+    using namespace std::string_literals;
+
+    solution::List list;
+    const std::string large(1 << 17, 'x');
+    for (const std::string & value : {"\0"s, ""s, "a\0b\0"s, large}) {
+        list.push_back(value);
+    }
+    for (std::size_t i = 0; i < 100000; ++i) {
+        list.push_back(std::to_string(i)).link(list.begin());
+    }
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file), 0);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(list.size(), deserialized.size());
+    auto it = deserialized.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_EQ(*it, *jt);
+        ASSERT_EQ(*it.next(), *jt.next());
+    }
+    ASSERT_EQ(*std::next(deserialized.begin(), 2), "a\0b\0"s);
+}
+
+TEST(SerializationTest, invalid_random)
+{
+    solution::List list;
+    list.push_back("1");
+
+    // Version 1 record whose "random" index is out of range
+    std::size_t random = 1;
+    auto * file = std::fopen("buffer", "wb");
+    std::fwrite("2", sizeof(char), 2, file);
+    std::fwrite(&random, sizeof(random), 1, file);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    ASSERT_NE(list.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(*list.begin(), "1");
+}
+
+TEST(SerializationTest, invalid_random_v2)
+{
+    solution::List list;
+    list.push_back("1");
+
+    // A single record whose "random" index is out of range
+    std::vector<char> data(solution::format::HEADER_SIZE);
+    solution::format::Header header;
+    header.m_count = 1;
+    header.m_payload_size = 1;
+    header.encode(data.data());
+    solution::format::FrameEncoder frame(data);
+    frame.add("2", 2);
+    frame.flush();
+
+    auto * file = std::fopen("buffer", "wb");
+    std::fwrite(data.data(), sizeof(char), data.size(), file);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    ASSERT_NE(list.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(*list.begin(), "1");
+}
+
+TEST(SerializationTest, truncated)
+{
+    solution::List list;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        list.push_back(std::to_string(i));
+    }
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file), 0);
+    const auto size = std::ftell(file);
+    std::fclose(file);
+
+    std::vector<char> data(size);
+    file = std::fopen("buffer", "rb");
+    ASSERT_EQ(std::fread(data.data(), sizeof(char), data.size(), file), data.size());
+    std::fclose(file);
+
+    file = std::fopen("buffer", "wb");
+    std::fwrite(data.data(), sizeof(char), data.size() - 1, file);
+    std::fclose(file);
+
+    solution::List deserialized;
+    file = std::fopen("buffer", "rb");
+    ASSERT_NE(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    ASSERT_TRUE(deserialized.empty());
+}
+
+TEST(SerializationTest, unknown_size)
+{
+    // The size of a pipe is unknown, so the declared sizes are checked against the frames read
+    const auto deserialize = [](const std::vector<char> & data) {
+        int fds[2];
+        EXPECT_EQ(::pipe(fds), 0);
+        EXPECT_EQ(::write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+        ::close(fds[1]);
+        solution::io::FdSource source(fds[0]);
+        solution::List list;
+        const auto result = list.deserialize(source);
+        ::close(fds[0]);
+        EXPECT_TRUE(list.empty());
+        return result;
+    };
+
+    // 2^33 nodes declared by empty frames of 2^32 - 1 records
+    std::vector<char> data(solution::format::HEADER_SIZE);
+    solution::format::Header header;
+    header.m_count = std::uint64_t{1} << 33;
+    header.encode(data.data());
+    for (std::size_t i = 0; i < 2; ++i) {
+        char frame[solution::format::FRAME_HEADER_SIZE];
+        solution::format::put_u32(frame, 0xFFFFFFFF);
+        solution::format::put_u32(frame + 4, 0);
+        data.insert(data.end(), frame, frame + sizeof(frame));
+    }
+    data.resize(64);
+    ASSERT_EQ(deserialize(data), 1);
+
+    // A frame holds less than two bytes per record
+    data.resize(solution::format::HEADER_SIZE);
+    header.m_count = 1000;
+    header.encode(data.data());
+    char frame[solution::format::FRAME_HEADER_SIZE];
+    solution::format::put_u32(frame, 1000);
+    solution::format::put_u32(frame + 4, 1000);
+    data.insert(data.end(), frame, frame + sizeof(frame));
+    data.resize(data.size() + 1000);
+    ASSERT_EQ(deserialize(data), 1);
+
+    // A dictionary of 2^52 bytes
+    data.resize(solution::format::HEADER_SIZE);
+    header.m_flags = solution::format::FLAG_DICTIONARY;
+    header.encode(data.data());
+    char section[solution::format::DICTIONARY_HEADER_SIZE];
+    solution::format::put_u64(section, 1);
+    solution::format::put_u64(section + 8, std::uint64_t{1} << 52);
+    data.insert(data.end(), section, section + sizeof(section));
+    data.resize(data.size() + 1000);
+    ASSERT_EQ(deserialize(data), 1);
+}
+
+TEST(SerializationTest, corrupted)
+{
+    solution::List list;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        list.push_back("element " + std::to_string(i));
+    }
+
+    const auto corrupt = [&list](const solution::SerializeOptions & options) {
+        auto * file = std::fopen("buffer", "wb");
+        EXPECT_EQ(list.serialize(file, options), 0);
+        std::fclose(file);
+        // A digit of a payload in the middle of the first frame is changed
+        file = std::fopen("buffer", "r+b");
+        std::fseek(file, 30000, SEEK_SET);
+        char c = '\0';
+        do {
+            EXPECT_EQ(std::fread(&c, sizeof(char), 1, file), 1);
+        } while (c < '0' || c > '9');
+        std::fseek(file, -1, SEEK_CUR);
+        c = c == '0' ? '1' : '0';
+        std::fwrite(&c, sizeof(char), 1, file);
+        std::fclose(file);
+    };
+
+    solution::List deserialized;
+    deserialized.push_back("unchanged");
+    solution::SerializeOptions options;
+    for (const bool compress : {false, true}) {
+        options.compress = compress;
+        corrupt(options);
+        auto * file = std::fopen("buffer", "rb");
+        ASSERT_NE(deserialized.deserialize(file), 0);
+        std::fclose(file);
+        ASSERT_EQ(deserialized.size(), 1);
+        ASSERT_EQ(*deserialized.begin(), "unchanged");
+    }
+
+    // Without checksums the change goes unnoticed
+    options.compress = false;
+    options.checksum = false;
+    corrupt(options);
+    auto * file = std::fopen("buffer", "rb");
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    ASSERT_FALSE(std::equal(deserialized.begin(), deserialized.end(), list.begin(), list.end()));
+}
+
+TEST(SerializationTest, parallel_serialization)
+{
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes;
+    for (std::size_t i = 0; i < 300000; ++i) {
+        nodes.push_back(list.push_back(std::to_string(i)));
+    }
+    for (std::size_t i = 0; i < nodes.size(); i += 2) {
+        nodes[i].link(nodes[nodes.size() - 1 - i]);
+    }
+    // Some nodes are reused, so the order of slots differs from the order of nodes
+    list.erase(nodes[10]);
+    list.insert(nodes[20], "inserted").link(nodes[0]);
+
+    const auto read_all = [](const char * name) {
+        auto * file = std::fopen(name, "rb");
+        std::vector<char> data;
+        char buffer[4096];
+        for (std::size_t read; (read = std::fread(buffer, sizeof(char), sizeof(buffer), file)) != 0;) {
+            data.insert(data.end(), buffer, buffer + read);
+        }
+        std::fclose(file);
+        return data;
+    };
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file), 0);
+    std::fclose(file);
+    const auto sequential = read_all("buffer");
+
+    solution::SerializeOptions options;
+    options.threads = 4;
+    options.index = true;
+    file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.serialize(file, options), 0);
+    std::fclose(file);
+    const auto parallel = read_all("buffer");
+    ASSERT_GT(parallel.size(), sequential.size());
+    ASSERT_TRUE(std::equal(sequential.begin() + 8, sequential.end(), parallel.begin() + 8));
+
+    file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file, {4}), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(list.size(), deserialized.size());
+    auto it = deserialized.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_EQ(*it, *jt);
+        ASSERT_EQ(*it.next(), *jt.next());
+    }
+    ASSERT_EQ(it, deserialized.end());
+    ASSERT_EQ(*std::prev(it), *std::prev(list.end()));
+
+    // The deserialized list stays fully functional
+    deserialized.erase(deserialized.begin());
+    deserialized.push_front("first").link(std::prev(deserialized.end()));
+    ASSERT_EQ(*deserialized.begin(), "first");
+    ASSERT_EQ(*deserialized.begin().next(), *std::prev(list.end()));
+    ASSERT_EQ(deserialized.size(), list.size());
+}
+
+TEST(SerializationTest, dictionary)
+{
+    solution::List list;
+    const std::string_view statuses[] = {"pending", "running", "completed", "failed"};
+    for (std::size_t i = 0; i < 100000; ++i) {
+        list.push_back(statuses[i * i % 4]);
+    }
+    std::next(list.begin(), 3).link(std::prev(list.end()));
+
+    const auto write = [&list](bool dictionary) {
+        solution::SerializeOptions options;
+        options.dictionary = dictionary;
+        auto * file = std::fopen("buffer", "wb");
+        EXPECT_EQ(list.serialize(file, options), 0);
+        const auto size = std::ftell(file);
+        std::fclose(file);
+        return size;
+    };
+    const auto plain = write(false);
+    ASSERT_LT(write(true) * 3, plain);
+
+    auto * file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(deserialized.size(), list.size());
+    ASSERT_TRUE(std::equal(deserialized.begin(), deserialized.end(), list.begin(), list.end()));
+    ASSERT_EQ(std::next(deserialized.begin(), 3).next(), std::prev(deserialized.end()));
+    // Equal payloads share the storage
+    ASSERT_EQ(deserialized.begin()->data(), std::next(deserialized.begin(), 2)->data());
+
+    // They keep sharing it once the payloads are moved
+    for (auto it = deserialized.begin(); deserialized.size() > 8;) {
+        it = deserialized.erase(it);
+    }
+    ASSERT_TRUE(std::equal(deserialized.begin(), deserialized.end(), std::prev(list.end(), 8), list.end()));
+    ASSERT_EQ(deserialized.begin()->data(), std::next(deserialized.begin(), 4)->data());
+}
+
+TEST(SerializationTest, compression)
+{
+    solution::List list;
+    std::vector<solution::List::Iterator> nodes;
+    for (std::size_t i = 0; i < 300000; ++i) {
+        nodes.push_back(list.push_back("item " + std::to_string(i % 1000)));
+    }
+    for (std::size_t i = 0; i < nodes.size(); i += 3) {
+        nodes[i].link(nodes[i / 3]);
+    }
+
+    const auto write = [&list](const solution::SerializeOptions & options) {
+        auto * file = std::fopen("buffer", "wb");
+        EXPECT_EQ(list.serialize(file, options), 0);
+        const auto size = std::ftell(file);
+        std::fclose(file);
+        return size;
+    };
+    const auto plain = write({});
+    solution::SerializeOptions options;
+    options.compress = true;
+    ASSERT_LT(write(options) * 2, plain);
+    options.index = true;
+    options.threads = 4;
+    write(options);
+
+    auto * file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file, {4}), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(deserialized.size(), list.size());
+    auto it = deserialized.begin();
+    for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+        ASSERT_EQ(*it, *jt);
+        ASSERT_EQ(*it.next(), *jt.next());
+    }
+}
+
+TEST(SerializationTest, background_serialization)
+{
+    solution::List list;
+    std::vector<std::string> expected;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        expected.push_back(std::to_string(i));
+        list.push_back(expected.back());
+    }
+    list.begin().link(std::prev(list.end()));
+
+    auto * file = std::fopen("buffer", "wb");
+    auto result = list.serialize_async(file);
+    // The list is changed while it is serialized
+    list.assign(list.begin(), "changed");
+    list.begin().link(list.begin());
+    list.pop_back();
+    for (std::size_t i = 0; i < 1000; ++i) {
+        list.push_front("new");
+    }
+    ASSERT_EQ(result.get(), 0);
+    std::fclose(file);
+
+    file = std::fopen("buffer", "rb");
+    solution::List deserialized;
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+
+    ASSERT_EQ(deserialized.size(), expected.size());
+    ASSERT_TRUE(std::equal(deserialized.begin(), deserialized.end(), expected.begin()));
+    ASSERT_EQ(deserialized.begin().next(), std::prev(deserialized.end()));
+
+    ASSERT_NE(list.serialize_async(nullptr).get(), 0);
+
+    // The payloads outlive the arena while they are serialized, a frozen list is thawed meanwhile
+    file = std::fopen("buffer", "wb");
+    result = list.serialize_async(file);
+    list.clear();
+    for (std::size_t i = 0; i < 10; ++i) {
+        list.push_back(std::to_string(i));
+    }
+    ASSERT_TRUE(list.freeze());
+    ASSERT_EQ(result.get(), 0);
+    std::fclose(file);
+    file = std::fopen("buffer", "rb");
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    ASSERT_EQ(deserialized.size(), expected.size() - 1 + 1000);
+    ASSERT_EQ(*deserialized.begin(), "new");
+    ASSERT_EQ(*std::prev(deserialized.end()), expected[expected.size() - 2]);
+
+    char memory[256];
+    file = fmemopen(memory, sizeof(memory), "wb");
+    result = list.serialize_async(file);
+    list.begin().link(list.begin());
+    list.erase(list.begin());
+    ASSERT_EQ(result.get(), 0);
+    std::fclose(file);
+    file = fmemopen(memory, sizeof(memory), "rb");
+    ASSERT_EQ(deserialized.deserialize(file), 0);
+    std::fclose(file);
+    ASSERT_EQ(deserialized.size(), 10);
+    ASSERT_EQ(*deserialized.begin(), "0");
+    ASSERT_EQ(deserialized.begin().next(), deserialized.end());
+}
+
+TEST(SerializationTest, journal)
+{
+    solution::List list;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        list.push_back(std::to_string(i));
+    }
+    std::next(list.begin(), 5).link(std::prev(list.end()));
+
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.snapshot(file), 0);
+    std::fclose(file);
+
+    const auto expect_restored = [&list] {
+        auto * snapshot = std::fopen("buffer", "rb");
+        auto * journal = std::fopen("buffer.journal", "rb");
+        solution::List restored;
+        restored.push_back("This should be removed");
+        ASSERT_EQ(restored.restore(snapshot, journal), 0);
+        std::fclose(snapshot);
+        std::fclose(journal);
+
+        ASSERT_EQ(restored.size(), list.size());
+        auto it = restored.begin();
+        for (auto jt = list.begin(); jt != list.end(); ++it, ++jt) {
+            ASSERT_EQ(*it, *jt);
+            ASSERT_EQ(*it.next(), *jt.next());
+        }
+        ASSERT_EQ(it, restored.end());
+    };
+
+    auto * journal = std::fopen("buffer.journal", "wb");
+    list.erase(std::next(list.begin(), 10));
+    list.insert(std::next(list.begin(), 20), "inserted").link(std::next(list.begin(), 3));
+    list.assign(list.begin(), "assigned");
+    list.push_back("last").link(list.begin());
+    ASSERT_EQ(list.checkpoint(journal), 0);
+    // The journal grows with the number of changes, not with the size of the list
+    ASSERT_LT(std::ftell(journal), 100);
+
+    list.pop_front();
+    std::prev(list.end()).link(std::prev(list.end()));
+    list.pop_back();
+    list.push_front("first");
+    ASSERT_EQ(list.checkpoint(journal), 0);
+    std::fclose(journal);
+    expect_restored();
+
+    // Restored list keeps appending to the same journal
+    file = std::fopen("buffer", "rb");
+    journal = std::fopen("buffer.journal", "rb");
+    solution::List restored;
+    ASSERT_EQ(restored.restore(file, journal), 0);
+    std::fclose(file);
+    std::fclose(journal);
+    journal = std::fopen("buffer.journal", "ab");
+    restored.insert(std::next(restored.begin(), 2), "restored").link(std::prev(restored.end()));
+    list.insert(std::next(list.begin(), 2), "restored").link(std::prev(list.end()));
+    ASSERT_EQ(restored.checkpoint(journal), 0);
+    // An interrupted checkpoint leaves a truncated segment that is ignored
+    std::fwrite("\x89LSJ\x01", sizeof(char), 5, journal);
+    std::fclose(journal);
+    expect_restored();
+
+    // Compaction
+    file = std::fopen("buffer", "wb");
+    ASSERT_EQ(restored.snapshot(file), 0);
+    std::fclose(file);
+    journal = std::fopen("buffer.journal", "wb");
+    restored.clear();
+    restored.push_back("1");
+    list.clear();
+    list.push_back("1");
+    ASSERT_EQ(restored.checkpoint(journal), 0);
+    std::fclose(journal);
+    expect_restored();
+}
+
+TEST(SerializationTest, invalid_journal)
+{
+    solution::List list;
+    for (const std::string_view value : {"1", "2", "3"}) {
+        list.push_back(value);
+    }
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.snapshot(file), 0);
+    std::fclose(file);
+
+    // Erases the node 7 that does not exist
+    auto * journal = std::fopen("buffer.journal", "wb");
+    std::fwrite("\x89LSJ\x01\0\0\0\0\0\0\0\x02\0\0\0\0\0\0\0\x02\x07", sizeof(char), 22, journal);
+    std::fclose(journal);
+
+    file = std::fopen("buffer", "rb");
+    journal = std::fopen("buffer.journal", "rb");
+    ASSERT_NE(list.restore(file, journal), 0);
+    std::fclose(file);
+    std::fclose(journal);
+    ASSERT_EQ(list.size(), 3);
+
+    journal = std::fopen("buffer.journal", "ab");
+    solution::List untracked;
+    ASSERT_NE(untracked.checkpoint(journal), 0);
+    std::fclose(journal);
+}
+
+TEST(SerializationTest, frozen)
+{
+    solution::List list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(std::string(i % 10, static_cast<char>('a' + i % 26)));
+    }
+    std::vector<solution::List::Iterator> iterators;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        iterators.push_back(it);
+    }
+    for (std::size_t i = 0; i < iterators.size(); i += 3) {
+        iterators[i].link(iterators[i * 7 % iterators.size()]);
+    }
+    std::vector<std::string> expected(list.begin(), list.end());
+    std::vector<std::string> serialized;
+    for (const auto & options : {solution::SerializeOptions{solution::format::VERSION_1}, solution::SerializeOptions{}}) {
+        std::vector<char> buffer;
+        solution::io::BufferSink sink(buffer);
+        ASSERT_EQ(list.serialize(sink, options), 0);
+        serialized.emplace_back(buffer.data(), buffer.size());
+    }
+
+    ASSERT_TRUE(list.freeze());
+    ASSERT_TRUE(list.frozen());
+    ASSERT_EQ(list.size(), 1000);
+    ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), expected);
+    ASSERT_EQ(*std::prev(list.end()), expected.back());
+    auto it = list.begin();
+    ASSERT_EQ(it.next(), list.begin());
+    std::advance(it, 3);
+    ASSERT_EQ(*it.move(), expected[21]);
+    ASSERT_EQ(std::next(list.begin()).next(), list.end());
+    // References outlive the iterators as for a list that is not frozen
+    const auto & first = *list.begin();
+    ASSERT_EQ(first, expected.front());
+    ASSERT_EQ(*std::make_reverse_iterator(list.end()), expected.back());
+    ASSERT_EQ(std::vector<std::string>(std::make_reverse_iterator(list.end()), std::make_reverse_iterator(list.begin())),
+              std::vector<std::string>(expected.rbegin(), expected.rend()));
+
+    // The same bytes as before freezing
+    std::size_t i = 0;
+    for (const auto & options : {solution::SerializeOptions{solution::format::VERSION_1}, solution::SerializeOptions{}}) {
+        std::vector<char> buffer;
+        solution::io::BufferSink sink(buffer);
+        ASSERT_EQ(list.serialize(sink, options), 0);
+        ASSERT_EQ(std::string(buffer.data(), buffer.size()), serialized[i++]);
+    }
+
+    // A change thaws the list
+    it = std::next(list.begin(), 5);
+    list.insert(it, "inserted");
+    ASSERT_FALSE(list.frozen());
+    expected.insert(expected.begin() + 5, "inserted");
+    ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), expected);
+    ASSERT_EQ(*std::next(list.begin(), 7).next(), expected[43]);
+
+    ASSERT_TRUE(list.freeze());
+    std::next(list.begin(), 2).link(list.begin());
+    ASSERT_FALSE(list.frozen());
+    ASSERT_EQ(std::next(list.begin(), 2).next(), list.begin());
+
+    ASSERT_TRUE(list.freeze());
+    list.thaw();
+    ASSERT_FALSE(list.frozen());
+    ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), expected);
+
+    // Changes of a snapshot are recorded by nodes
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.snapshot(file), 0);
+    std::fclose(file);
+    ASSERT_FALSE(list.freeze());
+
+    solution::List empty;
+    ASSERT_TRUE(empty.freeze());
+    ASSERT_EQ(empty.begin(), empty.end());
+    empty.push_back("first");
+    ASSERT_EQ(*empty.begin(), "first");
+}
+
+TEST(SerializationTest, compaction)
+{
+    solution::List list;
+    std::vector<solution::List::Iterator> iterators;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        // Every node is inserted in the middle, so the order of the list differs from the order in memory
+        iterators.push_back(list.insert(std::next(list.begin(), static_cast<long>(list.size() / 2)), std::to_string(i)));
+    }
+    for (std::size_t i = 0; i < iterators.size(); ++i) {
+        iterators[i].link(iterators[(i * 31 + 7) % iterators.size()]);
+    }
+    std::prev(list.end()).link(list.end());
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.snapshot(file), 0);
+    std::fclose(file);
+
+    const std::vector<std::string> expected(list.begin(), list.end());
+    std::vector<std::string> linked;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        linked.emplace_back(*it.next());
+    }
+    std::vector<std::string> walk;
+    list.for_each_random(list.begin(), 100, [&walk](std::string_view data) { walk.emplace_back(data); });
+    ASSERT_EQ(walk.size(), 100);
+
+    for (const auto order : {solution::List::Order::SEQUENTIAL, solution::List::Order::RANDOM}) {
+        list.compact(order);
+        ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), expected);
+        std::size_t i = 0;
+        for (auto it = list.begin(); it != list.end(); ++it, ++i) {
+            ASSERT_EQ(*it.next(), linked[i]);
+        }
+        std::vector<std::string> compacted_walk;
+        list.for_each_random(list.begin(), 100, [&](std::string_view data) { compacted_walk.emplace_back(data); }, 3);
+        ASSERT_EQ(compacted_walk, walk);
+    }
+    std::vector<std::string> tail;
+    list.for_each_random(std::prev(list.end()), 10, [&tail](std::string_view data) { tail.emplace_back(data); });
+    ASSERT_EQ(tail, std::vector<std::string>{expected.back()});
+
+    // Recorded changes refer to the relocated nodes
+    auto * journal = std::fopen("buffer.journal", "wb");
+    list.erase(std::next(list.begin(), 10));
+    list.insert(std::next(list.begin(), 20), "inserted").link(std::next(list.begin(), 3));
+    ASSERT_EQ(list.checkpoint(journal), 0);
+    std::fclose(journal);
+    file = std::fopen("buffer", "rb");
+    journal = std::fopen("buffer.journal", "rb");
+    solution::List restored;
+    ASSERT_EQ(restored.restore(file, journal), 0);
+    std::fclose(file);
+    std::fclose(journal);
+    ASSERT_EQ(std::vector<std::string>(restored.begin(), restored.end()), std::vector<std::string>(list.begin(), list.end()));
+    ASSERT_EQ(*std::next(restored.begin(), 20).next(), *std::next(list.begin(), 3));
+}
+
+TEST(SerializationTest, positional_access)
+{
+    std::mt19937 generator(42);
+    solution::List list;
+    std::vector<std::string> expected;
+    for (std::size_t i = 0; i < 100; ++i) {
+        expected.push_back(std::to_string(i));
+        list.push_back(expected.back());
+    }
+    ASSERT_EQ(*list.at(42), "42");
+    ASSERT_EQ(list.index_of(list.at(42)), 42);
+    ASSERT_TRUE(list.enable_index());
+    ASSERT_TRUE(list.indexed());
+
+    const auto check = [&] {
+        ASSERT_EQ(list.size(), expected.size());
+        ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), expected);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(*list.at(i), expected[i]);
+            ASSERT_EQ(list.index_of(list.at(i)), i);
+        }
+        ASSERT_EQ(list.at(expected.size()), list.end());
+        ASSERT_EQ(list.index_of(list.end()), expected.size());
+    };
+    for (int step = 0; step < 2000; ++step) {
+        const auto operation = generator() % 10;
+        if (operation < 5 || expected.empty()) {
+            const auto position = generator() % (expected.size() + 1);
+            const auto data = "v" + std::to_string(step);
+            list.insert(list.at(position), data);
+            expected.insert(expected.begin() + static_cast<long>(position), data);
+        }
+        else if (operation < 8) {
+            const auto position = generator() % expected.size();
+            list.erase(list.at(position));
+            expected.erase(expected.begin() + static_cast<long>(position));
+        }
+        else if (operation < 9) {
+            list.push_front("front");
+            expected.insert(expected.begin(), "front");
+            list.pop_back();
+            expected.pop_back();
+        }
+        else {
+            const auto first = generator() % expected.size();
+            const auto last = first + generator() % (std::min<std::size_t>(expected.size() - first, 20) + 1);
+            const auto next = list.erase(list.at(first), list.at(last));
+            ASSERT_EQ(next, list.at(first));
+            expected.erase(expected.begin() + static_cast<long>(first), expected.begin() + static_cast<long>(last));
+        }
+        if (step % 100 == 0) {
+            check();
+        }
+    }
+    check();
+
+    // The index follows the operations that replace the nodes
+    list.compact(solution::List::Order::RANDOM);
+    check();
+    ASSERT_TRUE(list.freeze());
+    check();
+    list.thaw();
+    check();
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    ASSERT_EQ(list.serialize(sink), 0);
+    list.clear();
+    expected.clear();
+    check();
+    list.push_back("after clear");
+    expected.push_back("after clear");
+    check();
+    solution::io::MemorySource source(buffer.data(), buffer.size());
+    ASSERT_EQ(list.deserialize(source), 0);
+    ASSERT_TRUE(list.indexed());
+    ASSERT_EQ(*list.at(list.size() - 1), *std::prev(list.end()));
+    ASSERT_EQ(list.index_of(std::prev(list.end())), list.size() - 1);
+
+    list.disable_index();
+    ASSERT_FALSE(list.indexed());
+    ASSERT_EQ(*list.at(list.size() - 1), *std::prev(list.end()));
+}
+
+TEST(SerializationTest, bulk_construction)
+{
+    const std::vector<std::string> none;
+    const solution::List empty(none.begin(), none.end());
+    ASSERT_TRUE(empty.empty());
+
+    solution::List list{"1", "2", "5"};
+    ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), (std::vector<std::string>{"1", "2", "5"}));
+
+    const std::vector<std::string> values{"3", std::string(100000, '4')};
+    ASSERT_EQ(*list.insert(std::prev(list.end()), values.begin(), values.end()), "3");
+    ASSERT_EQ(list.insert(list.end(), values.end(), values.end()), list.end());
+    ASSERT_EQ(std::vector<std::string>(list.begin(), list.end()), (std::vector<std::string>{"1", "2", "3", values[1], "5"}));
+
+    // Input iterators are consumed once
+    std::istringstream stream("6 7 8");
+    std::vector<std::string> words(std::istream_iterator<std::string>(stream), {});
+    ASSERT_EQ(*list.insert(list.begin(), words.begin(), words.end()), "6");
+    ASSERT_EQ(list.size(), 8);
+}
+
+TEST(SerializationTest, move_semantics)
+{
+    solution::List list{"1", "2", "3"};
+    list.begin().link(std::prev(list.end()));
+    ASSERT_TRUE(list.enable_index());
+    const auto * first = &*list.begin();
+
+    solution::List moved(std::move(list));
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.begin(), list.end());
+    ASSERT_EQ(moved.size(), 3);
+    // Nodes are not copied
+    ASSERT_EQ(&*moved.begin(), first);
+    ASSERT_EQ(*moved.begin().next(), "3");
+    // Iterators of the new list lead to its end and change its links
+    ASSERT_EQ(std::next(moved.begin()).next(), moved.end());
+    moved.begin().link(moved.end());
+    ASSERT_EQ(moved.begin().next(), moved.end());
+    moved.begin().link(std::prev(moved.end()));
+    ASSERT_TRUE(moved.indexed());
+    ASSERT_EQ(*moved.at(1), "2");
+
+    solution::List other{"4"};
+    other = std::move(moved);
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(std::vector<std::string>(other.begin(), other.end()), (std::vector<std::string>{"1", "2", "3"}));
+    ASSERT_EQ(*std::prev(other.end()), "3");
+    ASSERT_EQ(*other.at(2), "3");
+
+    // The moved-from lists stay usable
+    list.push_back("5");
+    moved.push_front("6");
+    ASSERT_EQ(*list.begin(), "5");
+    ASSERT_EQ(*moved.begin(), "6");
+}
+
+TEST(SerializationTest, splice)
+{
+    solution::List list{"1", "4"};
+    solution::List other;
+    std::vector<solution::List::Iterator> nodes;
+    for (int i = 0; i < 1000; ++i) {
+        nodes.push_back(other.push_back(std::to_string(i)));
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].link(nodes[(i * 7) % nodes.size()]);
+    }
+    other.erase(nodes[500]);
+    nodes.erase(nodes.begin() + 500);
+    const auto * first = &*other.begin();
+
+    list.splice(std::next(list.begin()), other);
+    ASSERT_TRUE(other.empty());
+    ASSERT_EQ(other.begin(), other.end());
+    ASSERT_EQ(list.size(), 1001);
+    // The nodes are moved, not copied
+    ASSERT_EQ(&*std::next(list.begin()), first);
+    ASSERT_EQ(*std::prev(list.end(), 2), "999");
+    ASSERT_EQ(*std::prev(list.end()), "4");
+    // The moved elements are reached through the iterators of this list
+    ASSERT_EQ(*std::next(list.begin(), 2).next(), "7");
+    std::prev(list.end(), 2).link(list.end());
+    ASSERT_EQ(std::prev(list.end(), 2).next(), list.end());
+
+    // Both lists keep working after the memory changed hands
+    other.push_back("x");
+    list.splice(list.end(), other);
+    list.splice(list.begin(), list);
+    list.push_back("y");
+    ASSERT_EQ(*std::prev(list.end(), 2), "x");
+    ASSERT_EQ(list.size(), 1003);
+
+    std::vector<char> buffer;
+    solution::io::BufferSink sink(buffer);
+    ASSERT_EQ(list.serialize(sink), 0);
+    solution::List deserialized;
+    solution::io::MemorySource source(buffer.data(), buffer.size());
+    ASSERT_EQ(deserialized.deserialize(source), 0);
+    ASSERT_TRUE(std::equal(list.begin(), list.end(), deserialized.begin(), deserialized.end()));
+    ASSERT_EQ(*std::next(deserialized.begin(), 2).next(), "7");
+}
+
+TEST(SerializationTest, splice_indexed_and_recorded)
+{
+    solution::List list{"a", "d"};
+    ASSERT_TRUE(list.enable_index());
+    solution::List other{"b", "c"};
+    other.begin().link(std::next(other.begin()));
+    list.splice(std::prev(list.end()), other);
+    for (std::size_t i = 0; i < list.size(); ++i) {
+        ASSERT_EQ(*list.at(i), std::string(1, static_cast<char>('a' + i)));
+        ASSERT_EQ(list.index_of(list.at(i)), i);
+    }
+
+    // Recorded changes are written as insertions
+    auto * file = std::fopen("buffer", "wb");
+    ASSERT_EQ(list.snapshot(file), 0);
+    std::fclose(file);
+    solution::List recorded{"e", "f"};
+    recorded.begin().link(std::next(recorded.begin()));
+    list.splice(list.end(), recorded);
+    ASSERT_TRUE(recorded.empty());
+    auto * journal = std::fopen("buffer.journal", "wb");
+    ASSERT_EQ(list.checkpoint(journal), 0);
+    std::fclose(journal);
+
+    file = std::fopen("buffer", "rb");
+    journal = std::fopen("buffer.journal", "rb");
+    solution::List restored;
+    ASSERT_EQ(restored.restore(file, journal), 0);
+    std::fclose(file);
+    std::fclose(journal);
+    ASSERT_TRUE(std::equal(list.begin(), list.end(), restored.begin(), restored.end()));
+    ASSERT_EQ(*std::prev(restored.end(), 2).next(), "f");
+}
+
 TEST(SerializationTest, strict_guarantees)
 {
     solution::List list;